@@ -0,0 +1,72 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "SceneObject.hpp"
+#include "ModelFileLoader.hpp"
+#include "pd_api.h"
+
+// Default time AssetLoader::update may spend per frame
+constexpr unsigned int ASSET_LOAD_BUDGET_MS = 20;
+
+// Result slot of a queued mesh load. SceneObject::set_mesh_handle takes
+// one before the mesh exists and picks the mesh up once m_ready is set.
+struct MeshHandle {
+    std::string m_filepath;
+    int m_lod_count{0};
+    float m_progress{0.0f};
+    bool m_ready{false};
+    bool m_failed{false};
+    ContentFingerprint m_content_fingerprint;
+
+    std::shared_ptr<IndexedVertexData> m_vertex_data;
+    std::vector<std::shared_ptr<VertexData>> m_lods;
+    std::vector<float> m_lod_screen_radii;
+};
+
+// Loads meshes a slice at a time across update() calls, so a loading
+// screen stays responsive. Files load in the order they were queued, .mesh
+// files through BinaryMeshLoader and anything else as OBJ. LODs are built
+// one per step after parsing.
+//
+// Loaded meshes are cached. Asking for a path again returns the same
+// handle, and a file whose ContentFingerprint matches an earlier one's
+// shares that mesh and its LODs instead of building its own. Entries stay
+// until purge_unused, so reloading a level costs nothing.
+class AssetLoader {
+    public:
+        AssetLoader();
+        ~AssetLoader();
+
+        std::shared_ptr<MeshHandle> load_mesh(std::string i_filepath, int i_lod_count = 0);
+        // Works through the queue for about i_budget_ms, a single step can
+        // overrun it. Returns true while loads are still pending.
+        bool update(PlaydateAPI* pd, unsigned int i_budget_ms = ASSET_LOAD_BUDGET_MS);
+        // Fraction of everything queued so far that has loaded, 0 to 1
+        float get_progress();
+        bool is_idle();
+        // Drop cached meshes that no SceneObject uses any more, returns
+        // the number of entries removed
+        int purge_unused();
+
+    private:
+        enum class LoadStage { Open, Parse, Lods };
+
+        void step(PlaydateAPI* pd);
+        void complete(PlaydateAPI* pd, bool i_failed);
+        bool share_cached_mesh(MeshHandle& i_handle);
+
+        std::deque<std::shared_ptr<MeshHandle>> m_queue;
+        std::unique_ptr<ModelFileLoader> m_file_loader;
+        LoadStage m_stage{LoadStage::Open};
+        int m_lods_built{0};
+        unsigned int m_start_ms{0};
+        int m_queued_count{0};
+        int m_completed_count{0};
+
+        std::unordered_map<std::string, std::shared_ptr<MeshHandle>> m_cache;
+        std::unordered_map<uint32_t, std::weak_ptr<MeshHandle>> m_cache_by_hash;
+};
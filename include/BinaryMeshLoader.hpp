@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ModelFileLoader.hpp"
+#include "MeshFormat.hpp"
+#include "pd_api.h"
+
+// Loads meshes written by tools/objconvert. Each stream is read with a
+// single file read, one stream per continue_load call, and expanded in
+// place inside the buffer the mesh ends up owning, so peak memory is one
+// copy of the mesh. Bounds and face planes come straight from the file.
+// The header's counts must give the file's exact size, and indices and
+// material ranges are checked against them as they are read. A mesh that
+// fails is reported and never built.
+class BinaryMeshLoader : public ModelFileLoader {
+    public:
+        BinaryMeshLoader();
+        ~BinaryMeshLoader();
+
+        bool begin_load(std::string i_filepath, PlaydateAPI* pd) override;
+        bool continue_load(PlaydateAPI* pd) override;
+        float get_load_progress() override;
+        ContentFingerprint get_content_fingerprint() override;
+        std::shared_ptr<IndexedVertexData> finish_load(PlaydateAPI* pd) override;
+
+    private:
+        bool read_stream(void* o_data, uint32_t i_size, PlaydateAPI* pd);
+        bool read_positions(PlaydateAPI* pd);
+        bool read_normals(PlaydateAPI* pd);
+        // o_largest is the largest index read, -1 if there were none
+        bool read_indices(std::vector<int>& o_indices, int& o_largest, PlaydateAPI* pd);
+        // Whether the ranges tile [0, triangle count) in order
+        bool ranges_cover_triangles();
+        void close(PlaydateAPI* pd);
+
+        std::string m_filepath;
+        SDFile* m_file{nullptr};
+        MeshFileHeader m_header;
+        int m_streams_read{0};
+        bool m_failed{false};
+        uint32_t m_content_hash{0};
+        uint32_t m_content_size{0};
+
+        // Handed to the mesh by finish_load
+        std::vector<float> m_vertex_buffer;
+        std::vector<float> m_normal_buffer;
+        std::vector<int> m_index_buffer;
+        std::vector<int> m_normal_index_buffer;
+        std::vector<glm::vec4> m_face_planes;
+        std::vector<MeshMaterialRange> m_material_ranges;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pd_api.h"
+#include "utils.hpp"
+
+constexpr int FILE_READER_DEFAULT_BLOCK_SIZE = 8 * 1024;
+
+// Reads an SDFile in large blocks and hands out records (lines by default)
+// as views. A view stays valid until the next call on the reader. Records
+// that straddle a block boundary are stitched together in a reused
+// buffer, so reading allocates nothing once it has warmed up.
+class BufferedFileReader {
+    public:
+        BufferedFileReader(PlaydateAPI* pd, int i_block_size = FILE_READER_DEFAULT_BLOCK_SIZE);
+        ~BufferedFileReader();
+
+        bool open(const char* i_filepath);
+        void close();
+        bool is_open();
+
+        // Next line without its terminator, "\r\n" endings are handled.
+        // Returns false at end of file.
+        bool next_line(std::string_view& o_line);
+        // Next run of bytes up to i_delimiter, which is not included
+        bool next_record(char i_delimiter, std::string_view& o_record);
+        // Raw read that drains the block buffer before the file
+        int read(void* o_data, int i_size);
+        // Bytes handed out so far
+        int get_offset();
+        // FNV-1a of every block read from the file so far, the whole file
+        // once reading has reached the end
+        uint32_t get_content_hash();
+        // Bytes read from the file so far
+        uint32_t get_content_size();
+
+    private:
+        bool refill();
+
+        PlaydateAPI* m_pd;
+        SDFile* m_file{nullptr};
+        std::vector<char> m_block;
+        int m_position{0};
+        int m_end{0};
+        // File offset of the start of m_block
+        int m_block_offset{0};
+        bool m_eof{true};
+        uint32_t m_content_hash{FNV1A_SEED};
+        uint32_t m_content_size{0};
+        std::string m_carry;
+};
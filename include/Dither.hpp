@@ -0,0 +1,248 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+// Ordered dither threshold tables. A pixel is white when its material's LUT
+// level is greater than the table entry at (y & 7, x & 7). Every table is
+// generated by the constexpr functions below, so they sit in read-only data
+// and nothing is built at startup.
+//
+// Materials pick one with a non-standard MTL statement, e.g.
+//
+//   newmtl hull
+//   dither clustered
+//
+// Ordered patterns repeat every few rows, so a flat area changes fewer
+// rows from frame to frame than it would under blue noise.
+using DitherTable = std::array<std::array<uint8_t, 8>, 8>;
+
+enum class DitherKernel : uint8_t {
+    Bayer8,
+    Bayer4,
+    ClusteredDot,
+    BlueNoise
+};
+
+constexpr int DITHER_KERNEL_COUNT = 4;
+
+namespace dither_detail {
+
+// Rank i of i_count spread over 0 to 255 the way the old runtime Bayer
+// matrix was normalized
+constexpr uint8_t rank_to_threshold(int i_rank, int i_count) {
+    return (uint8_t)(i_rank * 255 / i_count);
+}
+
+constexpr DitherTable ranks_to_table(const int (&i_ranks)[64]) {
+    DitherTable table{};
+    for (int i = 0; i < 64; i++) {
+        table[i / 8][i % 8] = rank_to_threshold(i_ranks[i], 64);
+    }
+    return table;
+}
+
+// Squared distance on the 8x8 torus, so the tables tile without seams
+constexpr int torus_distance_sqr(int i_a, int i_b) {
+    int dx = (i_a % 8) - (i_b % 8);
+    int dy = (i_a / 8) - (i_b / 8);
+    dx = dx < 0 ? -dx : dx;
+    dy = dy < 0 ? -dy : dy;
+    dx = dx > 4 ? 8 - dx : dx;
+    dy = dy > 4 ? 8 - dy : dy;
+    return dx * dx + dy * dy;
+}
+
+constexpr double exp_negative(double i_x) {
+    /* e^x for x <= 0: a short series for e^(x / 16), then squared 4 times */
+    double x = i_x / 16.0;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int i = 1; i < 10; i++) {
+        term *= x / i;
+        sum += term;
+    }
+    for (int i = 0; i < 4; i++) {
+        sum *= sum;
+    }
+    return sum;
+}
+
+}
+
+// Bayer matrix of i_size (2, 4 or 8) by the usual recursion, tiled to 8x8
+constexpr DitherTable make_bayer_table(int i_size) {
+    int ranks[8][8]{};
+    for (int size = 1; size < i_size; size *= 2) {
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                int v = ranks[y][x];
+                ranks[y][x + size] = 4 * v + 2;
+                ranks[y + size][x] = 4 * v + 3;
+                ranks[y + size][x + size] = 4 * v + 1;
+                ranks[y][x] = 4 * v;
+            }
+        }
+    }
+    DitherTable table{};
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) {
+            table[y][x] = dither_detail::rank_to_threshold(
+                ranks[y % i_size][x % i_size], i_size * i_size);
+        }
+    }
+    return table;
+}
+
+// 45 degree halftone screen with two dots per tile. Pixels are ranked by
+// distance to the nearest dot centre, so white grows as round dots and the
+// dark end shrinks to black dots halfway between them.
+constexpr DitherTable make_clustered_dot_table() {
+    /* Half pixel units, centres at (1.5, 1.5) and (5.5, 5.5) */
+    const int centres[2][2] = {{3, 3}, {11, 11}};
+    int keys[64]{};
+    for (int i = 0; i < 64; i++) {
+        int px = (i % 8) * 2 + 1;
+        int py = (i / 8) * 2 + 1;
+        int nearest = 1 << 20;
+        for (const auto& centre : centres) {
+            int dx = px - centre[0];
+            int dy = py - centre[1];
+            dx = dx < 0 ? -dx : dx;
+            dy = dy < 0 ? -dy : dy;
+            dx = dx > 8 ? 16 - dx : dx;
+            dy = dy > 8 ? 16 - dy : dy;
+            int d = dx * dx + dy * dy;
+            nearest = d < nearest ? d : nearest;
+        }
+        keys[i] = nearest * 64 + i;
+    }
+    int ranks[64]{};
+    for (int i = 0; i < 64; i++) {
+        for (int j = 0; j < 64; j++) {
+            if (keys[j] < keys[i]) ranks[i]++;
+        }
+    }
+    return dither_detail::ranks_to_table(ranks);
+}
+
+// Tileable blue noise by void and cluster on the 8x8 torus. A seed pattern
+// is relaxed by moving its tightest cluster into its largest void, then
+// pixels are ranked by taking clusters out of it and filling voids back in.
+constexpr DitherTable make_blue_noise_table() {
+    constexpr double sigma = 1.5;
+    double weights[64][64]{};
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            weights[a][b] = dither_detail::exp_negative(
+                -dither_detail::torus_distance_sqr(a, b) / (2.0 * sigma * sigma));
+        }
+    }
+
+    /* Energy of each pixel from the set pixels of a pattern */
+    struct Pattern {
+        bool m_set[64]{};
+        double m_energy[64]{};
+        int m_count = 0;
+
+        constexpr void toggle(int i_pixel, const double (&i_weights)[64][64]) {
+            double sign = m_set[i_pixel] ? -1.0 : 1.0;
+            m_set[i_pixel] = !m_set[i_pixel];
+            m_count += m_set[i_pixel] ? 1 : -1;
+            for (int p = 0; p < 64; p++) {
+                m_energy[p] += sign * i_weights[i_pixel][p];
+            }
+        }
+        constexpr int tightest_cluster() const {
+            int best = -1;
+            for (int p = 0; p < 64; p++) {
+                if (m_set[p] && (best < 0 || m_energy[p] > m_energy[best])) best = p;
+            }
+            return best;
+        }
+        constexpr int largest_void() const {
+            int best = -1;
+            for (int p = 0; p < 64; p++) {
+                if (!m_set[p] && (best < 0 || m_energy[p] < m_energy[best])) best = p;
+            }
+            return best;
+        }
+    };
+
+    Pattern seed;
+    uint32_t random = 12345;
+    while (seed.m_count < 7) {
+        random = random * 1103515245u + 12345u;
+        int pixel = (random >> 16) % 64;
+        if (!seed.m_set[pixel]) seed.toggle(pixel, weights);
+    }
+    for (int i = 0; i < 64; i++) {
+        int cluster = seed.tightest_cluster();
+        seed.toggle(cluster, weights);
+        int hole = seed.largest_void();
+        seed.toggle(hole, weights);
+        if (hole == cluster) break;
+    }
+
+    int ranks[64]{};
+    Pattern pattern = seed;
+    for (int rank = seed.m_count - 1; rank >= 0; rank--) {
+        int cluster = pattern.tightest_cluster();
+        pattern.toggle(cluster, weights);
+        ranks[cluster] = rank;
+    }
+    pattern = seed;
+    for (int rank = seed.m_count; rank < 64; rank++) {
+        int hole = pattern.largest_void();
+        pattern.toggle(hole, weights);
+        ranks[hole] = rank;
+    }
+    return dither_detail::ranks_to_table(ranks);
+}
+
+// True when the 64 entries are all different, i.e. the table has a
+// distinct level for every pixel of the tile
+constexpr bool has_distinct_thresholds(const DitherTable& i_table) {
+    bool seen[256]{};
+    for (const auto& row : i_table) {
+        for (uint8_t threshold : row) {
+            if (seen[threshold]) return false;
+            seen[threshold] = true;
+        }
+    }
+    return true;
+}
+
+inline constexpr DitherTable DITHER_BAYER8 = make_bayer_table(8);
+inline constexpr DitherTable DITHER_BAYER4 = make_bayer_table(4);
+inline constexpr DitherTable DITHER_CLUSTERED_DOT = make_clustered_dot_table();
+inline constexpr DitherTable DITHER_BLUE_NOISE = make_blue_noise_table();
+
+static_assert(has_distinct_thresholds(DITHER_BAYER8), "Bayer 8x8 must rank every pixel");
+static_assert(has_distinct_thresholds(DITHER_CLUSTERED_DOT), "Clustered dot must rank every pixel");
+static_assert(has_distinct_thresholds(DITHER_BLUE_NOISE), "Blue noise must rank every pixel");
+
+constexpr const DitherTable& get_dither_table(DitherKernel i_kernel) {
+    switch (i_kernel) {
+        case DitherKernel::Bayer4: return DITHER_BAYER4;
+        case DitherKernel::ClusteredDot: return DITHER_CLUSTERED_DOT;
+        case DitherKernel::BlueNoise: return DITHER_BLUE_NOISE;
+        default: return DITHER_BAYER8;
+    }
+}
+
+// Kernel for an index stored in a mesh file, out of range falls back to Bayer 8x8
+constexpr DitherKernel dither_kernel_from_index(uint32_t i_index) {
+    return i_index < (uint32_t)DITHER_KERNEL_COUNT ? (DitherKernel)i_index : DitherKernel::Bayer8;
+}
+
+// Name used by the MTL dither statement
+constexpr bool parse_dither_kernel(std::string_view i_name, DitherKernel& o_kernel) {
+    if (i_name == "bayer8") o_kernel = DitherKernel::Bayer8;
+    else if (i_name == "bayer4") o_kernel = DitherKernel::Bayer4;
+    else if (i_name == "clustered") o_kernel = DitherKernel::ClusteredDot;
+    else if (i_name == "bluenoise") o_kernel = DitherKernel::BlueNoise;
+    else return false;
+    return true;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "MeshFormat.hpp"
+
+// A mesh compiled into the game as constexpr arrays, see the headers in
+// include/meshes/ generated by tools/objconvert. The arrays live in
+// read-only data and are drawn in place by a non-owning IndexedVertexData,
+// nothing is read from disk or copied to the heap.
+struct EmbeddedMesh {
+    const float* m_positions;            // vertex_count * 3
+    const float* m_normals;              // normal_count * 3, unit length
+    const int* m_indices;                // triangle_count * 3
+    const int* m_normal_indices;         // triangle_count * 3
+    const glm::vec4* m_face_planes;      // triangle_count
+    const MeshMaterialRange* m_material_ranges;
+    int m_vertex_count;
+    int m_normal_count;
+    int m_triangle_count;
+    int m_range_count;
+    glm::vec3 m_bounds_center;
+    float m_bounds_radius;
+};
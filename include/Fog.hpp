@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include "ScreenGlobals.hpp"
+
+// Depth fog. Past FOG_START the dithered level of a pixel blends linearly
+// towards FOG_LEVEL, reaching it at FOG_END, where objects and triangles
+// are culled and the far plane sits (see ScreenGlobals.hpp). Both are view
+// depths, distance along the camera's forward axis.
+constexpr float FOG_START = 12.0f;
+// Level, 0 to 255 like a material LUT entry, that distant pixels fade to
+constexpr int FOG_LEVEL = 96;
+
+// Blend factors are 0 to 256, in 1/256ths of the way to FOG_LEVEL
+constexpr int FOG_FACTOR_ONE = 256;
+
+namespace fog_detail {
+
+// Depth buffer value, z in 0 to 1 times INT16_MAX, of a view depth
+constexpr int depth_of_view_depth(float i_depth) {
+    float z_ndc = (FAR_PLANE + NEAR_PLANE) / (FAR_PLANE - NEAR_PLANE)
+        - 2.0f * FAR_PLANE * NEAR_PLANE / ((FAR_PLANE - NEAR_PLANE) * i_depth);
+    return (int)((z_ndc * 0.5f + 0.5f) * INT16_MAX);
+}
+
+constexpr int factor_of_view_depth(float i_depth) {
+    float t = (i_depth - FOG_START) / (FOG_END - FOG_START);
+    t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    return (int)(t * FOG_FACTOR_ONE + 0.5f);
+}
+
+}
+
+// Depth values are dense towards the far plane, so the table is indexed by
+// INT16_MAX - z and only covers the band from FOG_START outwards
+constexpr int FOG_TABLE_SIZE = INT16_MAX - fog_detail::depth_of_view_depth(FOG_START) + 1;
+
+struct FogTable {
+    uint16_t m_factors[FOG_TABLE_SIZE];
+};
+
+constexpr FogTable make_fog_table() {
+    FogTable table{};
+    for (int i = 0; i < FOG_TABLE_SIZE; i++) {
+        /* Inverse of depth_of_view_depth */
+        float z_ndc = (float)(INT16_MAX - i) / INT16_MAX * 2.0f - 1.0f;
+        float depth = 2.0f * FAR_PLANE * NEAR_PLANE
+            / ((FAR_PLANE + NEAR_PLANE) - z_ndc * (FAR_PLANE - NEAR_PLANE));
+        table.m_factors[i] = fog_detail::factor_of_view_depth(depth);
+    }
+    return table;
+}
+
+inline constexpr FogTable FOG_TABLE = make_fog_table();
+
+// Fogged level of a pixel at depth buffer value i_z
+inline int apply_fog(int i_level, int i_z) {
+    int index = INT16_MAX - i_z;
+    if (index >= FOG_TABLE_SIZE) return i_level;
+    int factor = index < 0 ? FOG_FACTOR_ONE : FOG_TABLE.m_factors[index];
+    return i_level + (((FOG_LEVEL - i_level) * factor) >> 8);
+}
+
+// Blend factor, 0 to FOG_FACTOR_ONE, at a view depth
+inline int fog_factor_at_depth(float i_view_depth) {
+    if (i_view_depth <= FOG_START) return 0;
+    return fog_detail::factor_of_view_depth(i_view_depth);
+}
+
+// Fogged level at a view depth, for whole flat shaded faces
+inline int apply_fog_at_depth(int i_level, float i_view_depth) {
+    int factor = fog_factor_at_depth(i_view_depth);
+    return i_level + (((FOG_LEVEL - i_level) * factor) >> 8);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include "pd_api.h"
+
+// Copies the rendered frame into the display frame buffer, but only the
+// rows that differ from what is already there. Each contiguous run of
+// changed rows is marked updated, so unchanged rows cost neither the copy
+// nor the transfer to the display.
+class FramePresenter {
+    public:
+        FramePresenter();
+        ~FramePresenter();
+
+        void present(PlaydateAPI* pd, LCDBitmap* i_frame_buffer);
+        // Rows copied to the display by the last present call
+        int get_rows_pushed();
+
+    private:
+        int m_rows_pushed;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include "ScreenGlobals.hpp"
+
+// View-space frustum of the screen projection, for culling bounding spheres
+// before any of their vertices are transformed.
+struct Frustum {
+    float m_tan_x;
+    float m_tan_y;
+    float m_inv_len_x;
+    float m_inv_len_y;
+    float m_near;
+    float m_far;
+
+    Frustum(float i_near = NEAR_PLANE, float i_far = FAR_PLANE) {
+        m_tan_y = tanf(glm::radians(FIELD_OF_VIEW_DEGREES * 0.5f));
+        m_tan_x = m_tan_y * (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT;
+        m_inv_len_x = 1.0f / sqrtf(1.0f + m_tan_x * m_tan_x);
+        m_inv_len_y = 1.0f / sqrtf(1.0f + m_tan_y * m_tan_y);
+        m_near = i_near;
+        m_far = i_far;
+    }
+
+    // i_center is in view space, the camera looks down -z
+    bool sphere_visible(glm::vec3 i_center, float i_radius) const {
+        float depth = -i_center.z;
+        if (depth + i_radius < m_near) return false;
+        if (depth - i_radius > m_far) return false;
+        if ((depth * m_tan_x - i_center.x) * m_inv_len_x < -i_radius) return false;
+        if ((depth * m_tan_x + i_center.x) * m_inv_len_x < -i_radius) return false;
+        if ((depth * m_tan_y - i_center.y) * m_inv_len_y < -i_radius) return false;
+        if ((depth * m_tan_y + i_center.y) * m_inv_len_y < -i_radius) return false;
+        return true;
+    }
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+#include "SceneObject.hpp"
+#include "RenderTarget.hpp"
+#include "pd_api.h"
+
+constexpr int IMPOSTOR_CACHE_SIZE = 16;
+// Largest impostor bitmap edge, in pixels
+constexpr int IMPOSTOR_MAX_SIZE = 64;
+// Objects with a larger projected bounding radius are always rasterized
+constexpr float IMPOSTOR_MAX_SCREEN_RADIUS = 24.0f;
+// How far the view direction may drift before an impostor is re-rendered
+constexpr float IMPOSTOR_ANGLE_TOLERANCE_DEGREES = 4.0f;
+// Distance buckets per doubling of distance
+constexpr float IMPOSTOR_BUCKETS_PER_OCTAVE = 4.0f;
+// Fog is baked into the sprite, an object moving across one of this many
+// bands of fog density gets re-rendered
+constexpr int IMPOSTOR_FOG_BANDS = 16;
+
+// Cached 1-bit sprites of distant objects. An object is rendered once into
+// a small offscreen bitmap and then blitted with a depth test for as long as
+// it is seen from roughly the same direction and distance, under the same
+// lights and fog.
+class ImpostorCache {
+    public:
+        ImpostorCache();
+        ~ImpostorCache();
+
+        // Call once per frame before drawing through the cache
+        void begin_frame();
+        // Draw i_object, through an impostor if it is small enough on screen
+        // and rasterized normally otherwise
+        void draw(SceneObject& i_object, const Camera& i_camera, PlaydateAPI* pd,
+            RenderTarget& target, Lighting& lighting);
+        void clear();
+
+    private:
+        // Lights an impostor was shaded with: the directional and ambient
+        // light by generation, and copies of the point lights
+        // Lighting::select_lights picked for the object, strongest first.
+        // Lights out of the object's range don't take part.
+        struct ImpostorLights {
+            int m_directional_generation = 0;
+            int m_point_light_count = 0;
+            std::array<PointLight, LIGHT_MAX_PER_OBJECT> m_point_lights{};
+
+            bool operator==(const ImpostorLights&) const = default;
+        };
+
+        struct Impostor {
+            // SceneObject::get_id of the object, 0 for an empty slot
+            int m_object_id = 0;
+            int m_distance_bucket = 0;
+            // Lights and fog band it was rendered with
+            ImpostorLights m_lights;
+            int m_fog_band = 0;
+            // Object-space direction to the camera and camera up vector
+            glm::vec3 m_view_dir{0.0f, 0.0f, 1.0f};
+            glm::vec3 m_view_up{0.0f, 1.0f, 0.0f};
+            // Projected bounds at the time of rendering
+            glm::vec2 m_screen_center{0.0f, 0.0f};
+            float m_screen_radius = 0.0f;
+            int m_center_depth = 0;
+            // Nearest depth written while rendering, the coarse depth used
+            // for the blit
+            int m_depth = 0;
+            int m_origin_x = 0;
+            int m_origin_y = 0;
+            int m_width = 0;
+            int m_height = 0;
+            std::vector<uint8_t> m_bitmap;
+            std::vector<uint8_t> m_mask;
+            int m_last_used = 0;
+        };
+
+        Impostor* find(int i_object_id, int i_distance_bucket, const ImpostorLights& i_lights,
+            int i_fog_band, glm::vec3 i_view_dir, glm::vec3 i_view_up);
+        Impostor* evict();
+        void render(Impostor& i_impostor, SceneObject& i_object, const Camera& i_camera,
+            PlaydateAPI* pd, Lighting& lighting);
+        void blit(Impostor& i_impostor, glm::vec2 i_screen_center, float i_screen_radius,
+            int i_center_depth, RenderTarget& target);
+
+        std::vector<Impostor> m_impostors;
+        std::vector<int> m_scratch_depth;
+        int m_frame;
+        float m_cos_tolerance;
+};
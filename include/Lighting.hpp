@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+#include "PointLight.hpp"
+
+// Vertices are lit into a luminance of 0 to 255, which edges and spans
+// interpolate as fixed point with this many fractional bits
+constexpr int LIGHT_FIXED_SHIFT = 16;
+constexpr float LIGHT_MAX_LUMINANCE = 255.0f;
+// A point light reaches as far as its brightest possible contribution
+// stays above this many luminance steps
+constexpr float LIGHT_RANGE_CUTOFF = 1.0f;
+// Most point lights shading one object, the strongest ones are kept
+constexpr int LIGHT_MAX_PER_OBJECT = 4;
+
+// Light travelling along m_direction. The term is wrapped, (N.L + 1) / 2,
+// so faces turned away from it still get a gradient rather than flat black.
+struct DirectionalLight {
+    glm::vec3 m_direction{0.0f, -1.0f, 0.0f};
+    float m_intensity = 1.0f;
+};
+
+// Lights for a frame. prepare moves them into view space once per draw and
+// select_lights picks the point lights whose range reaches an object's
+// bounds, after that shading a vertex is a few dot products per selected
+// light however many lights the scene has.
+class Lighting {
+    public:
+        Lighting();
+        ~Lighting();
+
+        void set_directional_light(DirectionalLight i_light);
+        void set_ambient(float i_ambient);
+        void add_point_light(PointLight i_light);
+        void set_point_light_position(int i_idx, glm::vec3 i_position);
+        void clear_point_lights();
+        const std::vector<PointLight>& get_point_lights() const;
+        // Changes whenever the ambient or directional light is set, so
+        // anything computed from them can tell it is out of date
+        int get_directional_generation() const;
+
+        void prepare(const glm::mat4& i_view);
+        // Select up to LIGHT_MAX_PER_OBJECT point lights for a world space
+        // bounding sphere, strongest at its nearest point first
+        void select_lights(glm::vec3 i_center, float i_radius);
+        int get_selected_light_count() const;
+        // i_slot-th selected point light, 0 to get_selected_light_count - 1
+        const PointLight& get_selected_light(int i_slot) const;
+        // Ambient plus directional luminance for a unit view space normal.
+        // It depends on the normal only, so it can be cached per normal.
+        float shade_directional(glm::vec3 i_normal) const;
+        // Luminance of the selected point lights at a view space position
+        float shade_point_lights(glm::vec3 i_position, glm::vec3 i_normal) const;
+        // Whether select_lights picked any point light
+        bool has_point_lights() const;
+
+    private:
+        DirectionalLight m_directional;
+        float m_ambient{0.0f};
+        int m_directional_generation{0};
+        std::vector<PointLight> m_point_lights;
+
+        struct PreparedLight {
+            glm::vec3 m_world_position;
+            glm::vec3 m_view_position;
+            float m_luminance;
+            float m_range;
+        };
+
+        // Filled by prepare
+        glm::vec3 m_view_to_light{0.0f, 1.0f, 0.0f};
+        std::vector<PreparedLight> m_prepared;
+        // Filled by select_lights, indices into m_point_lights
+        std::array<int, LIGHT_MAX_PER_OBJECT> m_selected;
+        int m_selected_count{0};
+};
+
+// Distance at which a light of i_luminance (0 to 255) fades below
+// LIGHT_RANGE_CUTOFF, from its attenuation coefficients
+float point_light_range(const PointLight& i_light, float i_luminance);
+
+inline int luminance_to_fixed(float i_luminance) {
+    float clamped = i_luminance < 0.0f ? 0.0f : (i_luminance > LIGHT_MAX_LUMINANCE ? LIGHT_MAX_LUMINANCE : i_luminance);
+    return (int)(clamped * (1 << LIGHT_FIXED_SHIFT));
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include "RenderTarget.hpp"
+
+// Black depth-tested lines written straight into a RenderTarget. Depth is
+// stepped in 16.16 fixed point along the major axis and pixels that pass
+// write their depth, so geometry drawn later behind a line can't cover it.
+// i_depth_bias pulls the line towards the camera, enough to win against
+// faces it lies on.
+//
+// Thick lines are i_thickness pixels wide across the minor axis: a run of
+// rows per column for shallow lines, a masked run of bits within the row
+// for steep ones.
+
+// Screen space ends, z in 0 to 1. Clipped to the target first so ends far
+// off-screen cost nothing.
+void draw_line(RenderTarget& target, glm::vec3 i_a, glm::vec3 i_b,
+    int i_thickness, int i_depth_bias);
+
+// View space ends, clipped to the near plane and projected
+void draw_view_line(RenderTarget& target, const glm::mat4& i_projection,
+    glm::vec4 i_a, glm::vec4 i_b, int i_thickness, int i_depth_bias);
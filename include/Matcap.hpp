@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "pd_api.h"
+
+// Largest matcap edge in pixels
+constexpr int MATCAP_MAX_SIZE = 64;
+
+// Painted lighting: a square table of luminance indexed by the x and y of
+// a view space normal, the way a lit sphere looks from the camera. Rim
+// light, highlights and any falloff are authored in the image, so a
+// vertex is shaded with one lookup and spans cost the same as Smooth.
+//
+// Tables are binary 8-bit greymaps (PGM, "P5") with 255 as white, e.g.
+// Source/matcap.pgm. The image centre faces the camera and its top is up.
+class Matcap {
+    public:
+        Matcap();
+        ~Matcap();
+
+        // Square images up to MATCAP_MAX_SIZE only
+        bool load(PlaydateAPI* pd, const char* i_filepath);
+        bool is_loaded() const;
+        // Luminance, 0 to 255 like Lighting::shade_directional, of a unit
+        // view space normal quantized to the nearest texel
+        float shade(glm::vec3 i_normal) const;
+
+    private:
+        int m_size{0};
+        std::vector<uint8_t> m_luminance;
+};
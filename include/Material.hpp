@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MeshFormat.hpp"
+#include "Dither.hpp"
+
+// Light that reaches every surface regardless of its normal, scaled by a
+// material's ambient response (Ka)
+constexpr float MATERIAL_AMBIENT_LIGHT = 0.1f;
+
+// Surface response read from an MTL file. The rasterizer never evaluates
+// it per pixel: compile_luminance_lut folds ambient, diffuse and specular
+// into a table from the unlit luminance of a pixel to the luminance that
+// gets dithered, so materials cost one table lookup per pixel.
+struct Material {
+    std::string m_name;
+    glm::vec3 m_ambient{0.0f, 0.0f, 0.0f};
+    glm::vec3 m_diffuse{1.0f, 1.0f, 1.0f};
+    glm::vec3 m_specular{0.0f, 0.0f, 0.0f};
+    float m_shininess{0.0f};
+    // Threshold table the lit luminance is dithered against
+    DitherKernel m_dither_kernel{DitherKernel::Bayer8};
+    std::array<uint8_t, 256> m_luminance_lut;
+
+    // Identity response until the fields are set and the table compiled
+    Material();
+    void compile_luminance_lut();
+
+    // Shared identity material for meshes without one
+    static std::shared_ptr<Material> get_default();
+};
+
+// Run of consecutive indices drawn with one material
+struct MaterialRange {
+    int m_first_index;
+    int m_index_count;
+    std::shared_ptr<Material> m_material;
+};
+
+// Compiles the material ranges stored in a mesh file or embedded mesh.
+// Ranges that fall outside i_triangle_count triangles are dropped.
+std::vector<MaterialRange> create_material_ranges(
+    const MeshMaterialRange* i_ranges, int i_range_count, int i_triangle_count);
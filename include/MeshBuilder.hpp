@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "SceneObject.hpp"
+
+// Collects positions, normals and polygons as a loader streams them in and
+// writes the final IndexedVertexData buffers directly. Polygons are fan
+// triangulated; corners without a normal get the polygon's flat normal.
+class MeshBuilder {
+    public:
+        MeshBuilder();
+        ~MeshBuilder();
+
+        void clear();
+        void reserve(int i_position_count, int i_normal_count, int i_triangle_count);
+        void add_position(glm::vec3 i_position);
+        void add_normal(glm::vec3 i_normal);
+        // Corners are 0-based (vertex, texture, normal) indices, -1 where
+        // absent. Returns false and adds nothing for fewer than 3 corners or
+        // a corner past the positions added so far.
+        bool add_polygon(const std::array<int, 3>* i_corners, int i_corner_count);
+        // Polygons added from here on use i_material, until the next call
+        void set_material(std::shared_ptr<Material> i_material);
+
+        int position_count();
+        int normal_count();
+        int triangle_count();
+        // Hands the buffers over to a new mesh and leaves the builder empty
+        std::shared_ptr<IndexedVertexData> build(int i_stride);
+
+    private:
+        // Returns -(k + 1) for the k-th generated normal, resolved in build
+        int add_flat_normal(const std::array<int, 3>* i_corners, int i_corner_count);
+
+        std::vector<float> m_vertex_buffer;
+        std::vector<float> m_normal_buffer;
+        std::vector<int> m_index_buffer;
+        std::vector<int> m_normal_index_buffer;
+        // Kept apart so negative vn indices in the file stay relative to
+        // the normals the file itself declared
+        std::vector<glm::vec3> m_flat_normals;
+        // Index counts are filled in by build
+        std::vector<MaterialRange> m_material_ranges;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Binary mesh format written by tools/objconvert and read by
+// BinaryMeshLoader. All values are little endian. The file is a
+// MeshFileHeader followed by these streams, each padded to 4 bytes:
+//
+//   int16_t  positions[vertex_count * 3]      quantized to the bounding box
+//   int8_t   normals[normal_count * 2]        octahedral encoded
+//   uint16_t indices[triangle_count * 3]      into positions
+//   uint16_t normal_indices[triangle_count * 3]
+//   float    face_planes[triangle_count * 4]  object space, see IndexedVertexData
+//   MeshMaterialRange ranges[range_count]     triangles sorted by material
+//
+// Bump MESH_FORMAT_VERSION whenever the layout changes.
+
+constexpr uint32_t MESH_FORMAT_MAGIC = 0x4853454D; // "MESH"
+constexpr uint16_t MESH_FORMAT_VERSION = 3;
+
+struct MeshFileHeader {
+    uint32_t m_magic;
+    uint16_t m_version;
+    uint16_t m_flags;
+    uint32_t m_vertex_count;
+    uint32_t m_normal_count;
+    uint32_t m_triangle_count;
+    float m_bounds_min[3];
+    float m_bounds_max[3];
+    float m_sphere_center[3];
+    float m_sphere_radius;
+    uint32_t m_range_count;
+};
+
+static_assert(sizeof(MeshFileHeader) == 64, "MeshFileHeader must stay tightly packed");
+
+// A run of triangles drawn with one MTL material
+struct MeshMaterialRange {
+    float m_ambient[3];
+    float m_diffuse[3];
+    float m_specular[3];
+    float m_shininess;
+    uint32_t m_dither_kernel;         // DitherKernel, see Dither.hpp
+    uint32_t m_first_triangle;
+    uint32_t m_triangle_count;
+};
+
+static_assert(sizeof(MeshMaterialRange) == 52, "MeshMaterialRange must stay tightly packed");
+
+inline uint32_t mesh_stream_padding(uint32_t i_size) {
+    return (4 - (i_size & 3)) & 3;
+}
+
+// Size of a file with i_header's counts, in 64 bits so that no count can
+// wrap it around to a plausible size
+inline uint64_t mesh_file_size(const MeshFileHeader& i_header) {
+    auto padded = [](uint64_t i_size) { return i_size + mesh_stream_padding((uint32_t)i_size); };
+    uint64_t index_bytes = padded((uint64_t)i_header.m_triangle_count * 3 * sizeof(uint16_t));
+    return sizeof(MeshFileHeader)
+        + padded((uint64_t)i_header.m_vertex_count * 3 * sizeof(int16_t))
+        + padded((uint64_t)i_header.m_normal_count * 2)
+        + index_bytes * 2
+        + (uint64_t)i_header.m_triangle_count * 4 * sizeof(float)
+        + (uint64_t)i_header.m_range_count * sizeof(MeshMaterialRange);
+}
+
+inline int16_t quantize_position(float i_value, float i_min, float i_max) {
+    float extent = i_max - i_min;
+    float t = extent > 0.0f ? (i_value - i_min) / extent : 0.0f;
+    return (int16_t)(lroundf(t * 65535.0f) - 32768);
+}
+
+inline float dequantize_position(int16_t i_value, float i_min, float i_max) {
+    return i_min + ((int)i_value + 32768) * ((i_max - i_min) / 65535.0f);
+}
+
+inline void encode_octahedral(glm::vec3 i_normal, int8_t* o_encoded) {
+    float sum = fabsf(i_normal.x) + fabsf(i_normal.y) + fabsf(i_normal.z);
+    if (sum <= 0.0f) {
+        o_encoded[0] = 0;
+        o_encoded[1] = 0;
+        return;
+    }
+    float x = i_normal.x / sum;
+    float y = i_normal.y / sum;
+    if (i_normal.z < 0.0f) {
+        float fold_x = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float fold_y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = fold_x;
+        y = fold_y;
+    }
+    o_encoded[0] = (int8_t)lroundf(fminf(fmaxf(x, -1.0f), 1.0f) * 127.0f);
+    o_encoded[1] = (int8_t)lroundf(fminf(fmaxf(y, -1.0f), 1.0f) * 127.0f);
+}
+
+inline glm::vec3 decode_octahedral(const int8_t* i_encoded) {
+    float x = i_encoded[0] / 127.0f;
+    float y = i_encoded[1] / 127.0f;
+    float z = 1.0f - fabsf(x) - fabsf(y);
+    if (z < 0.0f) {
+        float unfold_x = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float unfold_y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = unfold_x;
+        y = unfold_y;
+    }
+    return glm::normalize(glm::vec3(x, y, z));
+}
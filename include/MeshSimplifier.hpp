@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <span>
+#include <glm/glm.hpp>
+
+// Quadric-error edge collapse (Garland & Heckbert) over an indexed triangle
+// mesh. Positions are collapsed; every surviving triangle corner keeps the
+// normal index it had in the source mesh.
+//
+// It runs on the device when LODs are built, where double is emulated in
+// software, so everything is float. Positions are moved to the mesh's
+// center and scaled to unit size first, which keeps quadric sums well
+// conditioned and lets the degeneracy tests use fixed epsilons.
+class MeshSimplifier {
+    public:
+        MeshSimplifier(
+            std::span<const float> i_vertex_buffer,
+            std::span<const int> i_index_buffer,
+            std::span<const int> i_normal_index_buffer);
+        ~MeshSimplifier();
+
+        void simplify(int i_target_triangle_count);
+
+        std::vector<float> get_vertex_buffer();
+        std::vector<int> get_index_buffer();
+        std::vector<int> get_normal_index_buffer();
+        // Source triangle each surviving triangle came from, in output order
+        std::vector<int> get_source_triangles();
+
+    private:
+        // Symmetric 4x4 matrix stored as its upper triangle
+        typedef std::array<float, 10> Quadric;
+
+        struct Triangle {
+            std::array<int, 3> m_vertices;
+            std::array<int, 3> m_normals;
+            // Index in the source mesh, degenerate source triangles are skipped
+            int m_source_index;
+            bool m_removed = false;
+        };
+
+        struct Collapse {
+            float m_cost;
+            int m_v1;
+            int m_v2;
+            int m_stamp1;
+            int m_stamp2;
+            glm::vec3 m_target;
+            bool operator>(const Collapse& i_other) const {
+                return m_cost > i_other.m_cost;
+            }
+        };
+
+        void compute_quadrics();
+        void add_boundary_quadrics();
+        Collapse evaluate_collapse(int i_v1, int i_v2);
+        bool collapse_flips_faces(int i_v, int i_other, glm::vec3 i_target);
+        int apply_collapse(Collapse& i_collapse);
+        void gather_neighbours(int i_v, std::vector<int>& o_neighbours);
+
+        // Normalized, source position = m_center + position * m_scale
+        std::vector<glm::vec3> m_positions;
+        glm::vec3 m_center;
+        float m_scale;
+        std::vector<Quadric> m_quadrics;
+        std::vector<Triangle> m_triangles;
+        std::vector<std::vector<int>> m_vertex_triangles;
+        std::vector<int> m_vertex_stamps;
+        std::vector<bool> m_vertex_removed;
+        int m_live_triangle_count;
+};
@@ -7,9 +7,41 @@
 #include <memory>
 #include "SceneObject.hpp"
 
+// Identifies a file's contents for AssetLoader's cache, files with equal
+// fingerprints are taken to hold the same mesh. The hash is only 32 bits,
+// so the size and counts are compared too.
+struct ContentFingerprint {
+    // FNV-1a of the bytes read and how many there were
+    uint32_t m_hash{0};
+    uint32_t m_size{0};
+    uint32_t m_vertex_count{0};
+    uint32_t m_triangle_count{0};
+
+    bool operator==(const ContentFingerprint&) const = default;
+};
+
 class ModelFileLoader {
     public:
-        virtual SceneObject create_scene_object_from_file(
-            std::string i_filepath, PlaydateAPI* pd
-        ) = 0;
-};
\ No newline at end of file
+        virtual ~ModelFileLoader() {}
+
+        // Loads the whole file in one go and generates LODs
+        SceneObject create_scene_object_from_file(std::string i_filepath, PlaydateAPI* pd);
+        // Number of simplified LODs generated for each loaded mesh (0-4)
+        void set_lod_count(int i_lod_count) { m_lod_count = i_lod_count; }
+
+        // Incremental loading, lets AssetLoader spread a file over frames.
+        // begin_load returns false if the file can't be opened.
+        virtual bool begin_load(std::string i_filepath, PlaydateAPI* pd) = 0;
+        // Does a small bounded amount of work, returns true once the whole
+        // file has been consumed
+        virtual bool continue_load(PlaydateAPI* pd) = 0;
+        // Fraction of the file consumed so far, 0 to 1
+        virtual float get_load_progress() = 0;
+        // Valid once continue_load returns true
+        virtual ContentFingerprint get_content_fingerprint() = 0;
+        // Builds the mesh, nullptr if the file was malformed
+        virtual std::shared_ptr<IndexedVertexData> finish_load(PlaydateAPI* pd) = 0;
+
+    protected:
+        int m_lod_count{0};
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Lighting.hpp"
+#include "Matcap.hpp"
+
+// Unit normals quantized onto an octahedral grid of this many cells a side.
+// Folding the octahedron flat spreads the entries about evenly over the
+// sphere, 32 a side is within about 3 degrees of any normal.
+constexpr int NORMAL_PALETTE_RESOLUTION = 32;
+constexpr int NORMAL_PALETTE_SIZE = NORMAL_PALETTE_RESOLUTION * NORMAL_PALETTE_RESOLUTION;
+
+// Palette entry nearest to a normal of any length
+uint16_t encode_palette_normal(glm::vec3 i_normal);
+// Unit normal of every palette entry, decoded once on first use
+const std::array<glm::vec3, NORMAL_PALETTE_SIZE>& get_normal_palette();
+
+// Shading of palette entries for one object. Meshes store their normals
+// as palette indices, so however many vertices an object has each entry
+// it uses is moved into view space and lit at most once per draw.
+class NormalPaletteCache {
+    public:
+        NormalPaletteCache();
+        ~NormalPaletteCache();
+
+        // Starts an object. Entries shaded for the previous one are stale
+        // from here on, its normal matrix or lights may differ.
+        void begin(const glm::mat3& i_normal_mat, const Lighting& i_lighting, const Matcap* i_matcap);
+        // Directional luminance, or the matcap's, of an entry
+        inline float shade(uint16_t i_index) {
+            if (m_stamps[i_index] != m_stamp) update(i_index);
+            return m_intensities[i_index];
+        }
+        // View space normal of an entry
+        inline const glm::vec3& get_view_normal(uint16_t i_index) {
+            if (m_stamps[i_index] != m_stamp) update(i_index);
+            return m_view_normals[i_index];
+        }
+
+    private:
+        void update(uint16_t i_index);
+
+        glm::mat3 m_normal_mat{1.0f};
+        const Lighting* m_lighting{nullptr};
+        const Matcap* m_matcap{nullptr};
+        std::array<glm::vec3, NORMAL_PALETTE_SIZE> m_view_normals;
+        std::array<float, NORMAL_PALETTE_SIZE> m_intensities;
+        std::array<int, NORMAL_PALETTE_SIZE> m_stamps{};
+        int m_stamp{0};
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <string_view>
+
+// Splits one OBJ line into whitespace separated tokens and parses numbers
+// in place. Nothing is copied or allocated, tokens are views into the line.
+class ObjLexer {
+    public:
+        ObjLexer(std::string_view i_line);
+
+        // Next token, empty once the line is exhausted. Comments end the line.
+        std::string_view next_token();
+        bool next_float(float& o_value);
+        bool next_int(int& o_value);
+        bool at_end();
+
+    private:
+        void skip_whitespace();
+
+        const char* m_cursor;
+        const char* m_end;
+};
+
+// Whole-token parsers, return false on malformed or trailing input and on
+// integers past INT_MAX
+bool parse_float(std::string_view i_text, float& o_value);
+bool parse_int(std::string_view i_text, int& o_value);
+
+// Parses a face corner in any of the forms v, v/vt, v//vn or v/vt/vn into
+// 0-based (vertex, texture, normal) indices, -1 where absent. Negative
+// indices count back from the number of elements seen so far.
+bool parse_face_vertex(
+    std::string_view i_token,
+    int i_vertex_count,
+    int i_texture_count,
+    int i_normal_count,
+    std::array<int, 3>& o_indices);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "SceneObject.hpp"
+#include "Camera.hpp"
+
+constexpr int OCCLUSION_WIDTH = 100;
+constexpr int OCCLUSION_HEIGHT = 60;
+
+// Low resolution software occlusion culling. Occluder meshes are rasterized
+// depth-only at a quarter of the screen resolution, then objects are tested
+// by the screen rectangle of their bounding sphere before being drawn.
+//
+// Depth is conservative on both sides: an occluder triangle is stored at its
+// farthest depth, an object is tested at the nearest point of its bounding
+// sphere over a rectangle that over-estimates its projection. Occluder
+// meshes must sit just behind the surfaces they stand for, as seen from
+// wherever the camera can be: a solid seen from outside is shrunk into
+// itself, a shell seen from inside, like the map, is grown outward. Their
+// outline must stay within the geometry's outline too, since coverage is
+// sampled at texel centers.
+class OcclusionBuffer {
+    public:
+        OcclusionBuffer();
+        ~OcclusionBuffer();
+
+        void clear();
+        // Rasterize i_object's occluder mesh, does nothing if it has none
+        void add_occluder(SceneObject& i_object, const Camera& i_camera);
+        bool is_occluded(SceneObject& i_object, const Camera& i_camera);
+        bool is_occluded(glm::vec3 i_world_center, float i_radius, const Camera& i_camera);
+
+    private:
+        void rasterize_triangle(glm::vec3 i_v1, glm::vec3 i_v2, glm::vec3 i_v3);
+
+        // View depth (distance along -z) of the nearest occluder per texel
+        std::vector<float> m_depth;
+        float m_focal_x;
+        float m_focal_y;
+};
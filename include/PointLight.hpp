@@ -9,4 +9,6 @@ struct PointLight {
     float m_attenuation_constant = 1.0f;
     float m_attenuation_linear = 0.09f;
     float m_attenuation_quadratic = 0.032f;
+
+    bool operator==(const PointLight&) const = default;
 };
\ No newline at end of file
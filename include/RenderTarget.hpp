@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+// 1-bit bitmap plus depth buffer that the rasterizer draws into.
+// Geometry is always projected to full-screen pixel coordinates; a target
+// covers the window of the screen starting at (m_origin_x, m_origin_y), so
+// an offscreen target can capture a small part of the screen.
+struct RenderTarget {
+    uint8_t* m_data = nullptr;
+    int m_rowbytes = 0;
+    int* m_depth_buffer = nullptr;
+    int m_width = 0;
+    int m_height = 0;
+    int m_origin_x = 0;
+    int m_origin_y = 0;
+};
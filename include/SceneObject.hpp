@@ -5,14 +5,56 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <memory>
+#include <span>
 #include <string>
 #include "Camera.hpp"
-#include "PointLight.hpp"
+#include "Lighting.hpp"
+#include "RenderTarget.hpp"
+#include "Material.hpp"
+#include "Matcap.hpp"
 #include "pd_api.h"
 
+struct EmbeddedMesh;
+
+// How an object's triangles are filled
+enum class ShadingMode {
+    // Luminance interpolated across the triangle and dithered per pixel
+    Smooth,
+    // One luminance per triangle, spans are filled with its dither row
+    // pattern a byte at a time. For faceted meshes.
+    Flat,
+    // Like Smooth, but vertices look their directional luminance up in
+    // DrawStyle::m_matcap by normal instead of lighting it. Point lights
+    // still add on top. Falls back to Smooth without a loaded matcap.
+    Matcap,
+    // Front-facing edges only, nothing filled. For debugging, and as a
+    // cheap level of detail for distant objects.
+    Wireframe
+};
+
+struct DrawStyle {
+    ShadingMode m_shading_mode = ShadingMode::Smooth;
+    // Table for ShadingMode::Matcap, may be shared by many objects
+    std::shared_ptr<const Matcap> m_matcap;
+    // Without the depth test flat spans are stored straight into the bitmap
+    // and depth is neither read nor written. Only for geometry drawn before
+    // anything it could overlap, such as a background.
+    bool m_depth_test = true;
+    // Black lines along silhouette and crease edges, needs IndexedVertexData
+    bool m_outlines = true;
+    // Width in pixels of outline and wireframe lines
+    int m_line_thickness = 1;
+    // Objects whose projected bounding radius, in pixels, drops below this
+    // are drawn as wireframe. 0 never switches.
+    float m_wireframe_screen_radius = 0.0f;
+};
+
 class VertexData {
     public:
         VertexData(std::vector<float> i_vertex_buffer);
+        // Meshes are shared through shared_ptr, never copied
+        VertexData(const VertexData&) = delete;
+        VertexData& operator=(const VertexData&) = delete;
         ~VertexData();
         void add_to_vertex_buffer(float i_f);
         virtual void send_to_gpu() = 0;
@@ -21,12 +63,19 @@ class VertexData {
             glm::mat4& model, 
             glm::mat4& view, 
             glm::mat4& projection, 
-            int* depth_buffer,
-            std::vector<std::vector<int>>& bayer_matrix
+            RenderTarget& target,
+            Lighting& lighting,
+            const DrawStyle& style
         );
         void print_vertex_buffer();
+        glm::vec3 get_bounds_center();
+        float get_bounds_radius();
     protected:
+        void compute_bounds(int i_stride);
+
         std::vector<float> m_vertex_buffer;
+        glm::vec3 m_bounds_center{0.0f, 0.0f, 0.0f};
+        float m_bounds_radius{0.0f};
 };
 
 template<int T>
@@ -50,7 +99,24 @@ class SimpleVertexData : public VertexData {
         std::array<int, T> m_offsets;
 };
 
-class IndexedVertexData : public VertexData {
+// Ambient and directional luminance of every corner and face of one mesh,
+// see IndexedVertexData::bake_lighting. Kept by the object it was baked
+// for, since meshes are shared between objects.
+struct BakedLighting {
+    std::vector<float> m_corner_intensities;
+    std::vector<float> m_face_intensities;
+};
+
+// An edge with the faces on either side, m_faces[1] is -1 where the mesh
+// is open. Whether the faces meet at a crease is decided once, when the
+// edges are built.
+struct MeshEdge {
+    int m_vertices[2];
+    int m_faces[2];
+    bool m_crease;
+};
+
+class IndexedVertexData : public VertexData, public std::enable_shared_from_this<IndexedVertexData> {
     public:
         IndexedVertexData(
             std::vector<float> i_vertex_buffer, 
@@ -58,6 +124,18 @@ class IndexedVertexData : public VertexData {
             std::vector<float> i_normal_buffer,
             std::vector<int> i_normal_index_buffer,
             int i_stride);
+        // Takes face planes and bounds precomputed offline, see MeshFormat.hpp
+        IndexedVertexData(
+            std::vector<float> i_vertex_buffer,
+            std::vector<int> i_index_buffer,
+            std::vector<float> i_normal_buffer,
+            std::vector<int> i_normal_index_buffer,
+            std::vector<glm::vec4> i_face_planes,
+            glm::vec3 i_bounds_center,
+            float i_bounds_radius,
+            int i_stride);
+        // Non-owning view of constexpr data, i_mesh must outlive the view
+        IndexedVertexData(const EmbeddedMesh& i_mesh);
         ~IndexedVertexData();
         void send_to_gpu();
 
@@ -66,16 +144,106 @@ class IndexedVertexData : public VertexData {
             glm::mat4& model, 
             glm::mat4& view, 
             glm::mat4& projection, 
-            int* depth_buffer,
-            std::vector<std::vector<int>>& bayer_matrix
+            RenderTarget& target,
+            Lighting& lighting,
+            const DrawStyle& style
         ) override;
+        // Draw with the ambient and directional light read from i_baked,
+        // which must have been baked from this mesh
+        void draw(
+            PlaydateAPI* pd,
+            glm::mat4& model,
+            glm::mat4& view,
+            glm::mat4& projection,
+            RenderTarget& target,
+            Lighting& lighting,
+            const DrawStyle& style,
+            const BakedLighting& i_baked
+        );
+        // Draw one copy of the mesh per model matrix. Face planes and scratch
+        // buffers are shared between the copies.
+        void draw_instanced(
+            PlaydateAPI* pd,
+            std::vector<glm::mat4>& models,
+            glm::mat4& view,
+            glm::mat4& projection,
+            RenderTarget& target,
+            Lighting& lighting,
+            const DrawStyle& style
+        );
+        int triangle_count();
+        std::span<const float> get_vertex_buffer();
+        std::span<const int> get_index_buffer();
+        // Ranges must cover the index buffer in order. A new mesh is one
+        // range with the default material.
+        void set_material_ranges(std::vector<MaterialRange> i_ranges);
+        const std::vector<MaterialRange>& get_material_ranges();
+        // Build a quadric-simplified copy with roughly i_triangle_ratio of
+        // this mesh's triangles. Normals are shared with the source mesh.
+        std::shared_ptr<IndexedVertexData> create_lod(float i_triangle_ratio);
+        // Mesh a LOD borrows its normals from and keeps alive, nullptr if
+        // the normals are its own
+        const IndexedVertexData* get_normal_source();
+        // Compute the ambient and directional luminance of every corner and
+        // face as drawn with i_model, darkened by up to i_occlusion where
+        // neighbouring vertices rise above a vertex's tangent plane. The
+        // occlusion term is per vertex, so it only reads well on meshes
+        // tessellated finer than the shadows they should get. Smooth and
+        // Flat draws given the result use it instead of lighting normals;
+        // point lights, which move, are still added on top.
+        void bake_lighting(const glm::mat4& i_model, Lighting& i_lighting, float i_occlusion,
+            BakedLighting& o_baked);
     private:
+        void compute_face_planes();
+        void compute_edges();
+        void quantize_normals();
+        void bind_owned_buffers();
+        void prepare_draw();
+        void draw_instance(
+            PlaydateAPI* pd,
+            glm::mat4& model,
+            glm::mat4& view,
+            glm::mat4& projection,
+            RenderTarget& target,
+            Lighting& lighting,
+            const DrawStyle& style,
+            const BakedLighting* i_baked
+        );
+
         int m_stride;
         std::vector<int> m_index_buffer;
         std::vector<float> m_normal_buffer;
         std::vector<int> m_normal_index_buffer;
+        // Object-space plane (unnormalized normal, offset) of each triangle
+        std::vector<glm::vec4> m_face_planes;
+        std::vector<MaterialRange> m_material_ranges;
+        std::vector<MeshEdge> m_edges;
+
+        // What drawing and simplification read, either the buffers above
+        // or an EmbeddedMesh's arrays
+        std::span<const float> m_vertex_view;
+        std::span<const float> m_normal_view;
+        std::span<const int> m_index_view;
+        std::span<const int> m_normal_index_view;
+        std::span<const glm::vec4> m_face_plane_view;
+        // Keeps the mesh m_normal_view borrows from alive, set on LODs
+        std::shared_ptr<IndexedVertexData> m_normal_source;
+        // Normal palette entry of each normal and of each face's plane, see
+        // NormalPalette.hpp. Drawing reads these instead of the normals.
+        std::vector<uint16_t> m_normal_palette_indices;
+        std::vector<uint16_t> m_face_palette_indices;
+
+        // Per-draw scratch, a vertex is transformed at most once per
+        // instance, tracked by matching its stamp against m_draw_stamp
+        std::vector<glm::vec4> m_view_positions;
+        std::vector<int> m_vertex_stamps;
+        // Whether each face faced the camera in the last draw_instance
+        std::vector<uint8_t> m_face_front;
+        int m_draw_stamp{0};
 };
 
+struct MeshHandle;
+
 struct Transform {
     glm::vec3 m_position{0.0f, 0.0f, 0.0f};
     glm::vec3 m_scale{1.0f, 1.0f, 1.0f};
@@ -86,10 +254,15 @@ class SceneObject {
     public:
         SceneObject();
         SceneObject(std::shared_ptr<VertexData> i_vertex_data);
+        SceneObject(SceneObject&&) = default;
+        SceneObject& operator=(SceneObject&&) = default;
         ~SceneObject();
 
-        void draw(const Camera& i_camera, PlaydateAPI* pd, int* depth_buffer,
-            std::vector<std::vector<int>>& bayer_matrix);
+        void draw(const Camera& i_camera, PlaydateAPI* pd, RenderTarget& target,
+            Lighting& lighting);
+        // Unique per constructed object and carried along when it is
+        // moved, so caches can key on it instead of its address
+        int get_id() const;
         void set_transform(Transform i_tf);
         void set_position(glm::vec3 i_position);
         void set_rotation(glm::quat i_rotation);
@@ -97,17 +270,103 @@ class SceneObject {
         void set_scale(glm::vec3 i_scale);
         void set_diffuse_color(glm::vec3 i_diffuse_color);
         void set_specular_strength(float i_specular_strength);
-        Transform get_transform();
+        void set_draw_style(DrawStyle i_style);
+        const DrawStyle& get_draw_style() const;
+        const Transform& get_transform() const;
+        std::shared_ptr<VertexData> get_vertex_data();
+        glm::mat4 get_model_matrix();
+        glm::vec3 get_world_bounds_center();
+        float get_world_bounds_radius();
+        static glm::mat4 get_projection_matrix();
+        // Distance in pixels from the eye to the screen plane, a world size
+        // divided by view distance times this gives its size in pixels
+        static float get_screen_focal_length();
+
+        // Append a coarser level of detail, used once the object's projected
+        // bounding radius drops below i_max_screen_radius pixels.
+        void add_lod(std::shared_ptr<VertexData> i_vertex_data, float i_max_screen_radius);
+        // Generate i_lod_count simplified levels, each with half the
+        // triangles of the previous one. Requires IndexedVertexData.
+        void generate_lods(int i_lod_count);
+        int get_current_lod();
+        // Schedule used by generate_lods for simplified level i_level (0 is
+        // the first one below full detail)
+        static float get_lod_triangle_ratio(int i_level);
+        static float get_lod_screen_radius(int i_level);
+
+        // Adopt the mesh behind i_handle once it finishes loading. Until
+        // then the object is skipped when drawn.
+        void set_mesh_handle(std::shared_ptr<MeshHandle> i_handle);
+        bool is_loaded();
+
+        // Mesh rasterized into the occlusion buffer on behalf of this
+        // object, usually a simplified hull of its visible mesh
+        void set_occluder(std::shared_ptr<IndexedVertexData> i_occluder);
+        std::shared_ptr<IndexedVertexData> get_occluder();
+        // Bake the current ambient and directional light for this object's
+        // meshes at its current transform, see
+        // IndexedVertexData::bake_lighting. Only for objects that never move.
+        // The bake is dropped once the object moves, its mesh changes, or
+        // it is drawn with other lights or after their ambient or
+        // directional light changed.
+        void bake_lighting(Lighting& i_lighting, float i_occlusion = 0.0f);
+        void clear_baked_lighting();
+        bool has_baked_lighting();
     private:
         void send_vertex_data_to_gpu();
         void pre_draw(const Camera& i_camera, int i_screen_width, int i_screen_height);
+        float get_screen_radius(glm::mat4& i_model_view);
+        void select_lod(float i_screen_radius);
 
+        int m_id;
         std::shared_ptr<VertexData> m_vertex_data;
+        std::vector<std::shared_ptr<VertexData>> m_lods;
+        std::vector<float> m_lod_screen_radii;
+        int m_current_lod{0};
+        std::shared_ptr<IndexedVertexData> m_occluder;
+        std::shared_ptr<MeshHandle> m_mesh_handle;
+        // Per level of detail, 0 being full detail. Levels that aren't
+        // IndexedVertexData are left empty.
+        std::vector<BakedLighting> m_baked_lighting;
+        // What the bake was made with, drawing with anything else drops it
+        glm::mat4 m_baked_model{1.0f};
+        const Lighting* m_baked_lights{nullptr};
+        int m_baked_light_generation{0};
         
         Transform m_transform;
 
         glm::vec3 m_diffuse_color{1.0f, 1.0f, 1.0f};
         float m_specular_strength{1.0f};
+        DrawStyle m_draw_style;
+};
+
+// Many copies of one mesh, each with its own transform, drawn as a batch.
+// Instances are culled by bounding sphere before any vertex work and the
+// view and projection setup is done once for the whole batch.
+class InstancedSceneObject {
+    public:
+        InstancedSceneObject();
+        InstancedSceneObject(std::shared_ptr<IndexedVertexData> i_vertex_data);
+        InstancedSceneObject(InstancedSceneObject&&) = default;
+        InstancedSceneObject& operator=(InstancedSceneObject&&) = default;
+        ~InstancedSceneObject();
+
+        void draw(const Camera& i_camera, PlaydateAPI* pd, RenderTarget& target,
+            Lighting& lighting);
+        int add_instance(Transform i_tf);
+        void set_instance_transform(int i_idx, Transform i_tf);
+        const Transform& get_instance_transform(int i_idx) const;
+        void set_draw_style(DrawStyle i_style);
+        int instance_count();
+        void clear_instances();
+    private:
+        std::shared_ptr<IndexedVertexData> m_vertex_data;
+        std::vector<Transform> m_transforms;
+        std::vector<glm::mat4> m_models;
+        // Scratch list of the models that survive culling
+        std::vector<glm::mat4> m_visible_models;
+        bool m_models_dirty{true};
+        DrawStyle m_draw_style;
 };
 
 #include "SimpleVertexData_impl.hpp"
\ No newline at end of file
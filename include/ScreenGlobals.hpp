@@ -5,6 +5,27 @@
 constexpr int PIXEL_SCALE = 1;
 
 constexpr float NEAR_PLANE = 0.1f;
+// Fog is opaque from this view depth on, see Fog.hpp. Nothing beyond it is
+// drawn, so it doubles as the far plane and bounds the draw distance.
+constexpr float FOG_END = 60.0f;
+constexpr float FAR_PLANE = FOG_END;
+constexpr float FIELD_OF_VIEW_DEGREES = 45.0f;
+
+// Fraction a LOD threshold must be crossed by before switching levels,
+// keeps objects hovering near a threshold from flickering between LODs
+constexpr float LOD_HYSTERESIS = 0.15f;
+// Projected bounding radius, in pixels, below which the first LOD is used.
+// Each further level halves it.
+constexpr float LOD_BASE_SCREEN_RADIUS = 48.0f;
+// Meshes are not simplified below this many triangles
+constexpr int LOD_MIN_TRIANGLES = 8;
+
+// Edges between two front faces bent by more than this are outlined along
+// with the silhouette
+constexpr float OUTLINE_CREASE_DEGREES = 40.0f;
+// Depth units outlines are pulled towards the camera, enough to win
+// against the faces they border
+constexpr int OUTLINE_DEPTH_BIAS = 2;
 
 constexpr int SCREEN_WIDTH = (LCD_COLUMNS / PIXEL_SCALE);
 constexpr int SCREEN_HEIGHT = (LCD_ROWS / PIXEL_SCALE);
\ No newline at end of file
@@ -1,64 +1,49 @@
 #pragma once
 
 #include "ModelFileLoader.hpp"
+#include "MeshBuilder.hpp"
+#include "BufferedFileReader.hpp"
 #include "pd_api.h"
+#include <map>
+#include <string_view>
 
-struct WFFace {
-    public:
-        WFFace(std::vector<std::string> &i_tokenized_line);
-        ~WFFace();
-
-        int vertex_count();
-        int get_vertex_idx(int face_idx);
-        bool vertex_has_texture(int idx);
-        bool vertex_has_normal(int idx);
-        int get_vertex_texture(int idx);
-        int get_vertex_normal(int idx);
+class ObjLexer;
 
-    private:
-        void add_vertices(std::vector<std::string> &i_tokenized_line);
-        void add_vertex(std::string &i_vert);
-
-        std::vector<std::array<int, 3>> m_vertices;
-};
+// Rough average OBJ line length, used to presize the mesh buffers
+constexpr int WF_OBJ_BYTES_PER_LINE_ESTIMATE = 28;
+// Lines parsed per continue_load call
+constexpr int WF_OBJ_LINES_PER_LOAD_STEP = 256;
 
 class WFObjLoader : public ModelFileLoader {
     public:
         WFObjLoader();
         ~WFObjLoader();
 
-        SceneObject create_scene_object_from_file(std::string i_filepath, PlaydateAPI* pd);
+        bool begin_load(std::string i_filepath, PlaydateAPI* pd) override;
+        bool continue_load(PlaydateAPI* pd) override;
+        float get_load_progress() override;
+        ContentFingerprint get_content_fingerprint() override;
+        std::shared_ptr<IndexedVertexData> finish_load(PlaydateAPI* pd) override;
 
     private:
-        std::vector<float> get_simple_vertex_buffer();
-        void parse_obj_file(std::string i_filepath, PlaydateAPI* pd);
-        void parse_obj_file_line(std::string i_line);
-        void add_vertex(std::vector<std::string> &i_tokenized_line);
-        void add_vertex_normal(std::vector<std::string> &i_tokenized_line);
-        glm::vec3 tokenized_line_to_vec3(std::vector<std::string> &i_tokenized_line);
-        void add_face(std::vector<std::string> &i_tokenized_line);
-        std::vector<float> face_to_simple_vertex_buffer(WFFace &i_face);
-        std::vector<int> face_to_index_buffer(WFFace &i_face);
-        std::vector<int> face_to_normal_index_buffer(WFFace &i_face);
-        std::vector<float> get_ordered_vertex_data_buffer();
-        std::vector<int> get_index_buffer();
-        std::vector<float> get_ordered_normal_buffer();
-        std::vector<int> get_normal_index_buffer();
-        void compute_and_store_normals();
-        void compute_and_store_normals_for_face(WFFace &i_face);
-
-        std::vector<glm::vec4> m_vertices;
-        std::vector<glm::vec3> m_vertex_normals;
-        std::vector<WFFace> m_faces;
+        void parse_obj_file_line(std::string_view i_line, PlaydateAPI* pd);
+        void add_vertex(ObjLexer &i_lexer, PlaydateAPI* pd);
+        void add_vertex_normal(ObjLexer &i_lexer, PlaydateAPI* pd);
+        glm::vec3 lexer_to_vec3(ObjLexer &i_lexer, PlaydateAPI* pd);
+        // A face with any malformed corner is skipped whole
+        void add_face(ObjLexer &i_lexer, PlaydateAPI* pd);
+        // Reads newmtl blocks from an .mtl next to the .obj into m_materials
+        void load_material_library(std::string_view i_filename, PlaydateAPI* pd);
+        void use_material(std::string_view i_name);
+
+        MeshBuilder m_builder;
+        std::unique_ptr<BufferedFileReader> m_reader;
+        int m_file_size{0};
+        uint32_t m_content_hash{0};
+        uint32_t m_content_size{0};
+        // Corners of the face being parsed, reused between lines
+        std::vector<std::array<int, 3>> m_face_corners;
+        int m_texture_count{0};
+        std::string m_directory;
+        std::map<std::string, std::shared_ptr<Material>, std::less<>> m_materials;
 };
-
-std::vector<std::string> tokenize(
-    std::string stringToSplit,
-    std::string delimeter);
-
-int count_occurrences(
-    std::string stringToScan, 
-    char charToCount);
-
-template <typename T>
-std::vector<T> concat(std::vector<T> &a, std::vector<T> &b);
\ No newline at end of file
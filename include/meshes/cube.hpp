@@ -0,0 +1,61 @@
+// Generated by tools/objconvert from cube.obj, do not edit
+#pragma once
+
+#include "EmbeddedMesh.hpp"
+
+inline constexpr int CUBE_VERTEX_COUNT = 8;
+inline constexpr int CUBE_NORMAL_COUNT = 8;
+inline constexpr int CUBE_TRIANGLE_COUNT = 12;
+inline constexpr int CUBE_RANGE_COUNT = 1;
+
+inline constexpr float CUBE_POSITIONS[CUBE_VERTEX_COUNT * 3] = {
+    -1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f,
+    -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f,
+    1.0f, -1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+    1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f,
+};
+
+inline constexpr float CUBE_NORMALS[CUBE_NORMAL_COUNT * 3] = {
+    -0.572768688f, -0.572768688f, -0.586405933f, 0.572768688f, -0.572768688f, -0.586405933f,
+    -0.572768629f, -0.572768629f, 0.586406112f, -0.572768688f, 0.572768688f, -0.586405933f,
+    0.572768629f, -0.572768629f, 0.586406112f, 0.572768629f, 0.572768629f, 0.586406112f,
+    0.572768688f, 0.572768688f, -0.586405933f, -0.572768629f, 0.572768629f, 0.586406112f,
+};
+
+inline constexpr int CUBE_INDICES[CUBE_TRIANGLE_COUNT * 3] = {
+    0, 1, 2, 2, 3, 0, 3, 1, 0, 2, 1, 4,
+    1, 5, 4, 6, 1, 3, 6, 5, 1, 2, 5, 7,
+    7, 3, 2, 4, 5, 2, 3, 5, 6, 7, 5, 3,
+};
+
+inline constexpr int CUBE_NORMAL_INDICES[CUBE_TRIANGLE_COUNT * 3] = {
+    0, 1, 2, 2, 3, 0, 3, 1, 0, 2, 1, 4,
+    1, 5, 4, 6, 1, 3, 6, 5, 1, 2, 5, 7,
+    7, 3, 2, 4, 5, 2, 3, 5, 6, 7, 5, 3,
+};
+
+inline constexpr glm::vec4 CUBE_FACE_PLANES[CUBE_TRIANGLE_COUNT] = {
+    {0.0f, -4.0f, 0.0f, -4.0f},
+    {-4.0f, 0.0f, 0.0f, -4.0f},
+    {0.0f, 0.0f, -4.0f, -4.0f},
+    {0.0f, -4.0f, 0.0f, -4.0f},
+    {4.0f, 0.0f, 0.0f, -4.0f},
+    {-0.0f, -0.0f, -4.0f, -4.0f},
+    {4.0f, 0.0f, -0.0f, -4.0f},
+    {0.0f, 0.0f, 4.0f, -4.0f},
+    {-4.0f, -0.0f, -0.0f, -4.0f},
+    {0.0f, -0.0f, 4.0f, -4.0f},
+    {0.0f, 4.0f, 0.0f, -4.0f},
+    {-0.0f, 4.0f, 0.0f, -4.0f},
+};
+
+inline constexpr MeshMaterialRange CUBE_MATERIAL_RANGES[CUBE_RANGE_COUNT] = {
+    {{0.789853811f, 0.813333333f, 0.694044471f}, {0.789853811f, 0.813333333f, 0.694044471f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0, 0, 12},
+};
+
+inline constexpr EmbeddedMesh CUBE_MESH{
+    CUBE_POSITIONS, CUBE_NORMALS, CUBE_INDICES, CUBE_NORMAL_INDICES,
+    CUBE_FACE_PLANES, CUBE_MATERIAL_RANGES,
+    CUBE_VERTEX_COUNT, CUBE_NORMAL_COUNT, CUBE_TRIANGLE_COUNT, CUBE_RANGE_COUNT,
+    {0.0f, 0.0f, 0.0f}, 1.73205078f
+};
@@ -0,0 +1,81 @@
+// Generated by tools/objconvert from icosahedron.obj, do not edit
+#pragma once
+
+#include "EmbeddedMesh.hpp"
+
+inline constexpr int ICOSAHEDRON_VERTEX_COUNT = 12;
+inline constexpr int ICOSAHEDRON_NORMAL_COUNT = 20;
+inline constexpr int ICOSAHEDRON_TRIANGLE_COUNT = 20;
+inline constexpr int ICOSAHEDRON_RANGE_COUNT = 1;
+
+inline constexpr float ICOSAHEDRON_POSITIONS[ICOSAHEDRON_VERTEX_COUNT * 3] = {
+    0.525733113f, 1.29938126e-05f, -0.850651026f, 1.29938126e-05f, -0.850651026f, -0.525733113f,
+    -0.525733113f, 1.29938126e-05f, -0.850651026f, 1.29938126e-05f, 0.850651026f, -0.525733113f,
+    -0.850651026f, 0.525733113f, 1.29938126e-05f, -0.850651026f, -0.525733113f, 1.29938126e-05f,
+    0.850651026f, 0.525733113f, 1.29938126e-05f, 0.850651026f, -0.525733113f, 1.29938126e-05f,
+    1.29938126e-05f, -0.850651026f, 0.525733113f, -0.525733113f, 1.29938126e-05f, 0.850651026f,
+    1.29938126e-05f, 0.850651026f, 0.525733113f, 0.525733113f, 1.29938126e-05f, 0.850651026f,
+};
+
+inline constexpr float ICOSAHEDRON_NORMALS[ICOSAHEDRON_NORMAL_COUNT * 3] = {
+    0.0f, -0.35557282f, -0.934648633f, 0.0f, 0.35557282f, -0.934648633f,
+    -0.572768688f, 0.572768688f, -0.586405933f, -0.934648633f, 0.0f, -0.35557282f,
+    -0.572768688f, -0.572768688f, -0.586405933f, 0.572768688f, 0.572768688f, -0.586405933f,
+    0.934648633f, 0.0f, -0.35557282f, 0.572768688f, -0.572768688f, -0.586405933f,
+    -0.35557282f, -0.934648633f, 0.0f, 0.35557282f, -0.934648633f, 0.0f,
+    -0.572768629f, -0.572768629f, 0.586406112f, -0.934648633f, 0.0f, 0.35557282f,
+    -0.572768629f, 0.572768629f, 0.586406112f, -0.35557282f, 0.934648633f, 0.0f,
+    0.35557282f, 0.934648633f, 0.0f, 0.572768629f, 0.572768629f, 0.586406112f,
+    0.934648633f, 0.0f, 0.35557282f, 0.572768629f, -0.572768629f, 0.586406112f,
+    0.0f, -0.35557282f, 0.934648633f, 0.0f, 0.35557282f, 0.934648633f,
+};
+
+inline constexpr int ICOSAHEDRON_INDICES[ICOSAHEDRON_TRIANGLE_COUNT * 3] = {
+    0, 1, 2, 3, 0, 2, 4, 3, 2, 5, 4, 2,
+    1, 5, 2, 0, 3, 6, 7, 0, 6, 0, 7, 1,
+    1, 8, 5, 1, 7, 8, 5, 8, 9, 4, 5, 9,
+    10, 4, 9, 10, 3, 4, 3, 10, 6, 10, 11, 6,
+    11, 7, 6, 7, 11, 8, 8, 11, 9, 11, 10, 9,
+};
+
+inline constexpr int ICOSAHEDRON_NORMAL_INDICES[ICOSAHEDRON_TRIANGLE_COUNT * 3] = {
+    0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3,
+    4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7,
+    8, 8, 8, 9, 9, 9, 10, 10, 10, 11, 11, 11,
+    12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15,
+    16, 16, 16, 17, 17, 17, 18, 18, 18, 19, 19, 19,
+};
+
+inline constexpr glm::vec4 ICOSAHEDRON_FACE_PLANES[ICOSAHEDRON_TRIANGLE_COUNT] = {
+    {-0.0f, -0.341640204f, -0.894444466f, -0.760855675f},
+    {0.0f, 0.341640234f, -0.894417167f, -0.76084131f},
+    {-0.552791297f, 0.552804947f, -0.552782834f, -0.760853112f},
+    {-0.894444466f, 0.0f, -0.341640204f, -0.760855675f},
+    {-0.552804947f, -0.552804947f, -0.552804947f, -0.760864794f},
+    {0.552791297f, 0.552782834f, -0.552769184f, -0.760841548f},
+    {0.894444466f, 0.0f, -0.341640204f, -0.760855675f},
+    {0.552804947f, -0.552782834f, -0.552791297f, -0.760853171f},
+    {-0.341640204f, -0.894444466f, 0.0f, -0.760855675f},
+    {0.341640204f, -0.894417167f, 0.0f, -0.76084131f},
+    {-0.552782893f, -0.552791297f, 0.552804947f, -0.760853231f},
+    {-0.894417167f, 0.0f, 0.341640204f, -0.76084131f},
+    {-0.552769184f, 0.552791297f, 0.552782834f, -0.760841548f},
+    {-0.341640204f, 0.894444466f, 0.0f, -0.760855675f},
+    {0.341640204f, 0.894417167f, -0.0f, -0.76084131f},
+    {0.552769184f, 0.552769184f, 0.552769184f, -0.760829926f},
+    {0.894417167f, 0.0f, 0.341640234f, -0.76084131f},
+    {0.552782893f, -0.552769184f, 0.552791297f, -0.760841608f},
+    {0.0f, -0.341640234f, 0.894444466f, -0.760855675f},
+    {0.0f, 0.341640204f, 0.894417167f, -0.76084131f},
+};
+
+inline constexpr MeshMaterialRange ICOSAHEDRON_MATERIAL_RANGES[ICOSAHEDRON_RANGE_COUNT] = {
+    {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0, 0, 20},
+};
+
+inline constexpr EmbeddedMesh ICOSAHEDRON_MESH{
+    ICOSAHEDRON_POSITIONS, ICOSAHEDRON_NORMALS, ICOSAHEDRON_INDICES, ICOSAHEDRON_NORMAL_INDICES,
+    ICOSAHEDRON_FACE_PLANES, ICOSAHEDRON_MATERIAL_RANGES,
+    ICOSAHEDRON_VERTEX_COUNT, ICOSAHEDRON_NORMAL_COUNT, ICOSAHEDRON_TRIANGLE_COUNT, ICOSAHEDRON_RANGE_COUNT,
+    {0.0f, 0.0f, 0.0f}, 1.00000119f
+};
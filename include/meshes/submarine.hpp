@@ -0,0 +1,492 @@
+// Generated by tools/objconvert from submarine.obj, do not edit
+#pragma once
+
+#include "EmbeddedMesh.hpp"
+
+inline constexpr int SUBMARINE_VERTEX_COUNT = 117;
+inline constexpr int SUBMARINE_NORMAL_COUNT = 104;
+inline constexpr int SUBMARINE_TRIANGLE_COUNT = 230;
+inline constexpr int SUBMARINE_RANGE_COUNT = 1;
+
+inline constexpr float SUBMARINE_POSITIONS[SUBMARINE_VERTEX_COUNT * 3] = {
+    7.56978989e-06f, -0.22558558f, 0.806999207f, -0.496886998f, -0.619625986f, 0.675979614f,
+    7.56978989e-06f, -0.619625986f, 0.675979614f, -0.496886998f, -0.619625986f, -0.196370125f,
+    -0.496886998f, -0.22558558f, -0.196370125f, -0.496886998f, -0.22558558f, 0.806999207f,
+    0.496886998f, -0.619625986f, 0.675979614f, 7.56978989e-06f, -0.619625986f, -0.196370125f,
+    -0.496886998f, -0.619625986f, -1.06871998f, -0.496886998f, 0.16841948f, -0.196370125f,
+    -0.496886998f, -0.22558558f, -1.06871998f, -0.496886998f, 0.16841948f, 0.806999207f,
+    -0.304212987f, 0.208223343f, 1.38036895f, -0.367477268f, 0.34592694f, 0.528492451f,
+    -0.304212987f, 0.449452341f, 1.38036895f, 7.56978989e-06f, 0.16841948f, 0.806999207f,
+    -0.354602993f, 0.358345747f, -0.562167406f, -0.362867415f, 0.350384951f, -0.0341954231f,
+    -0.496886998f, 0.412089765f, -1.06871998f, 7.56978989e-06f, 0.344724f, 0.529938936f,
+    -0.291869462f, 0.580787361f, 0.442314625f, 0.304212958f, 0.449452341f, 1.38036895f,
+    0.496886998f, 0.16841948f, 0.806999207f, 0.367477208f, 0.34592694f, 0.528492451f,
+    7.56978989e-06f, 0.449452341f, 1.38036895f, 7.56978989e-06f, 0.208223343f, 1.38036895f,
+    0.304212958f, 0.208223343f, 1.38036895f, 0.496886998f, -0.22558558f, 0.806999207f,
+    0.496886998f, -0.22558558f, -0.196370125f, 0.496886998f, 0.16841948f, -0.196370125f,
+    0.362867385f, 0.350384951f, -0.0341954231f, 0.291869432f, 0.580787361f, 0.442314625f,
+    0.496886998f, -0.22558558f, -1.06871998f, 0.354602963f, 0.358345747f, -0.562167406f,
+    0.496886998f, 0.412089765f, -1.06871998f, 0.496886998f, -0.619625986f, -1.06871998f,
+    0.496886998f, -0.619625986f, -0.196370125f, 7.56978989e-06f, -0.619625986f, -1.06871998f,
+    0.452426046f, -0.619625986f, -1.11322773f, 7.56978989e-06f, -0.619625986f, -1.11322773f,
+    -0.452426106f, -0.619625986f, -1.11322773f, 0.452426046f, -0.22558558f, -1.23111737f,
+    0.241600722f, -0.619625986f, -1.32402706f, -0.241600752f, -0.619625986f, -1.32402706f,
+    7.56978989e-06f, -0.619625986f, -1.32402706f, -0.452426106f, -0.22558558f, -1.23111737f,
+    -0.241600752f, -0.22558558f, -2.00115514f, 0.241600722f, -0.22558558f, -2.00115514f,
+    7.56978989e-06f, -0.22558558f, -2.00115514f, 0.452426046f, 0.288680136f, -1.23111737f,
+    0.241600722f, 0.16841948f, -2.00115514f, 0.100181073f, -0.0384544134f, -2.26564193f,
+    -0.100181103f, -0.0384544134f, -2.26564193f, 7.56978989e-06f, -0.0384544134f, -2.26564193f,
+    -0.241600752f, 0.16841948f, -2.00115514f, -0.452426106f, 0.288680136f, -1.23111737f,
+    7.56978989e-06f, 0.412089765f, -1.06871998f, 7.56978989e-06f, 0.288680136f, -1.23111737f,
+    7.56978989e-06f, 0.16841948f, -2.00115514f, -0.100181103f, 0.124935985f, -2.26564193f,
+    0.100181073f, 0.124935985f, -2.26564193f, 7.56978989e-06f, 0.124935985f, -2.26564193f,
+    7.56978989e-06f, 0.359053373f, -0.55955255f, 0.291869432f, 0.580787361f, -0.338794589f,
+    7.56978989e-06f, 0.580787361f, -0.338794589f, -0.291869462f, 0.580787361f, -0.338794589f,
+    -0.291869462f, 0.580787361f, 0.0517599583f, -0.263254941f, 0.929256737f, -0.300518036f,
+    7.56978989e-06f, 0.929256737f, -0.300518036f, 0.263254911f, 0.929256737f, -0.300518036f,
+    0.291869432f, 0.580787361f, 0.0517599583f, 0.263254911f, 0.929256737f, 0.0517599583f,
+    0.263254911f, 0.929256737f, 0.404037952f, 0.0858055651f, 0.929256737f, -0.0340285301f,
+    7.56978989e-06f, 0.929256737f, -0.069578886f, -0.0858056247f, 0.929256737f, -0.0340285301f,
+    -0.263254941f, 0.929256737f, 0.0517599583f, 7.56978989e-06f, 1.10209394f, -0.069578886f,
+    -0.12135008f, 0.929256737f, 0.0517599583f, -0.0858056247f, 1.10209394f, -0.0340285301f,
+    0.0858055651f, 1.10209394f, -0.0340285301f, 0.12135002f, 1.10209394f, 0.0517599583f,
+    0.12135002f, 0.929256737f, 0.0517599583f, 0.0858055651f, 0.929256737f, 0.137548447f,
+    0.0858055651f, 1.10209394f, 0.137548447f, 0.0984220803f, 1.25303006f, -0.071303606f,
+    0.117210299f, 1.29962707f, 0.00680732727f, 0.0208580792f, 1.22536206f, -0.114253521f,
+    -0.0700805187f, 1.23279214f, -0.0968399048f, -0.12109229f, 1.27100372f, -0.0292439461f,
+    -0.12135008f, 1.10209394f, 0.0517599583f, -0.057964474f, 1.37215853f, -0.176063538f,
+    0.0347786844f, 1.36734676f, -0.174672604f, 0.102758974f, 1.4201355f, -0.139734268f,
+    0.0661833584f, 1.33783889f, 0.074403286f, 0.106155723f, 1.49956632f, -0.0917770863f,
+    7.56978989e-06f, 1.10209394f, 0.173099041f, -0.0247400999f, 1.34526896f, 0.0917611122f,
+    0.0429823697f, 1.55914831f, -0.0587859154f, 0.14347437f, 1.45112944f, -0.266135931f,
+    0.16197446f, 1.57807708f, -0.267693639f, 0.0409352481f, 1.37431693f, -0.272533894f,
+    -0.085593313f, 1.39264417f, -0.283215761f, -0.121137768f, 1.43174052f, -0.143127918f,
+    -0.14348954f, 1.6222682f, -0.293396831f, 0.085593313f, 1.68078876f, -0.276372671f,
+    -0.161989629f, 1.49532056f, -0.291839004f, -0.0497758985f, 1.56396008f, -0.0601768494f,
+    -0.0409352779f, 1.69908094f, -0.286998868f, -0.117756188f, 1.51117134f, -0.0951151848f,
+    -0.102319241f, 1.31760073f, 0.0488669872f, -0.0858056247f, 1.10209394f, 0.137548447f,
+    7.56978989e-06f, 0.929256737f, 0.173099041f, -0.0858056247f, 0.929256737f, 0.137548447f,
+    7.56978989e-06f, 0.929256737f, 0.404037952f, -0.263254941f, 0.929256737f, 0.404037952f,
+    7.56978989e-06f, 0.580787361f, 0.442314625f,
+};
+
+inline constexpr float SUBMARINE_NORMALS[SUBMARINE_NORMAL_COUNT * 3] = {
+    0.0f, -0.319218874f, 0.947681069f, 0.0f, -1.0f, 0.0f,
+    -1.0f, 0.0f, 0.0f, 0.0f, -0.794671059f, 0.607040286f,
+    -0.947681069f, 0.0f, 0.319218874f, -0.80394721f, 0.594700694f, -4.16829593e-08f,
+    0.0f, 0.846776247f, 0.531949162f, 0.0f, 0.896526754f, -0.442989618f,
+    -0.507334054f, 0.829058111f, 0.235106111f, -0.951615155f, 0.307292402f, 0.0f,
+    0.0f, 0.343364269f, 0.939202309f, 0.0f, 0.0f, 1.0f,
+    0.947681069f, 0.0f, 0.319218874f, 1.0f, 0.0f, 0.0f,
+    0.80394721f, 0.594700694f, -4.16829593e-08f, 0.951615155f, 0.307292402f, 0.0f,
+    0.507334054f, 0.829058111f, 0.235106111f, 0.701517224f, 0.0f, -0.712652445f,
+    0.963153183f, -0.0819705203f, -0.256157726f, 0.690799952f, -0.21351999f, -0.690800011f,
+    -0.963153183f, -0.0819705203f, -0.256157726f, -0.701517224f, 0.0f, -0.712652445f,
+    -0.690799952f, -0.21351999f, -0.690800011f, 0.0f, -0.862211168f, -0.50654906f,
+    -0.879773557f, -0.409757555f, -0.241033882f, 0.879773557f, -0.409757555f, -0.241033882f,
+    0.965429068f, 0.0f, -0.260665864f, 0.0f, -0.812990427f, -0.58227706f,
+    0.883528829f, 0.0f, -0.468376756f, -0.883528829f, 0.0f, -0.468376756f,
+    -0.965429068f, 0.0f, -0.260665864f, 0.0f, 0.794670999f, -0.607040465f,
+    0.0f, 0.988267541f, -0.152732253f, 0.0f, 0.986637473f, -0.162930951f,
+    0.0f, 0.0f, -1.0f, 0.0f, 0.994599879f, 0.103784353f,
+    0.958050966f, 0.286427617f, -0.00987681001f, -0.0f, 0.701517224f, -0.712652445f,
+    0.0f, 0.701517224f, -0.712652445f, -0.958050966f, 0.286427617f, -0.00987681001f,
+    -0.996367335f, 0.0851596072f, 2.41740121e-08f, -0.955352008f, 0.295469701f, 0.0f,
+    0.0f, 0.113300793f, -0.993560672f, 0.955352008f, 0.295469701f, 0.0f,
+    0.996367335f, 0.0851596072f, 2.41740121e-08f, 0.0f, 1.0f, 0.0f,
+    -0.380232871f, 0.0f, -0.924890816f, -0.924890816f, 0.0f, -0.3802329f,
+    0.380232871f, 0.0f, -0.924890816f, 0.924890816f, 0.0f, -0.3802329f,
+    0.924890816f, 0.0f, 0.380232871f, 0.974629283f, -0.0289493706f, -0.221945301f,
+    0.919671118f, 0.110803746f, 0.376732767f, 0.908886909f, -0.172573477f, -0.37966162f,
+    0.539824605f, -0.251081169f, -0.803459823f, 0.348776013f, -0.373688579f, -0.859483659f,
+    -0.20411101f, -0.306166559f, -0.929839075f, -0.36349529f, -0.376029611f, -0.852333724f,
+    -0.827371418f, -0.155881599f, -0.539590061f, -0.910938978f, -0.184493974f, -0.368987948f,
+    -0.835189223f, -0.221079499f, -0.503569961f, -0.205386519f, -0.471180797f, -0.857790828f,
+    -0.0104319537f, -0.396414399f, -0.91801244f, 0.551629782f, -0.367753178f, -0.748640299f,
+    0.610801816f, -0.311898857f, -0.727763832f, 0.97904706f, -0.0988936722f, -0.178008527f,
+    0.832181752f, 0.208045438f, 0.513994694f, 0.995419204f, 0.00865581539f, -0.0952140167f,
+    0.836389899f, 0.274635494f, 0.47437042f, 0.3802329f, 0.0f, 0.924890816f,
+    0.372629553f, 0.264446795f, 0.889502764f, 0.206951246f, 0.333421439f, 0.919783294f,
+    0.694817245f, 0.414217979f, 0.587922215f, 0.19504945f, 0.524195373f, 0.828960121f,
+    0.960345268f, -0.13719219f, 0.242724583f, 0.722573757f, 0.508477807f, 0.468334764f,
+    0.946886182f, -0.198185503f, 0.253237039f, 0.59996295f, -0.7999506f, -0.0111105051f,
+    0.617665648f, -0.786119938f, -0.0224606451f, -0.0528906174f, -0.996107101f, -0.0705208927f,
+    0.0779959559f, -0.0259986296f, -0.996614575f, -0.128750756f, -0.980486393f, -0.148558557f,
+    -0.671713412f, -0.740023255f, 0.0341549031f, -0.694817185f, -0.414217979f, -0.587922275f,
+    -0.800893426f, -0.597850025f, -0.033840593f, 0.697562575f, 0.563415885f, 0.442683876f,
+    0.0223091505f, 0.580037951f, 0.814283967f, 0.0332370438f, 0.853084147f, 0.520713687f,
+    0.0794582888f, 0.862689972f, 0.499452114f, -0.682308555f, 0.602037013f, 0.414736599f,
+    -0.967229366f, 0.145604417f, 0.208006293f, -0.559205234f, 0.718978167f, 0.412746787f,
+    -0.967827022f, -0.0916888788f, 0.234316021f, -0.980198026f, 0.118811883f, 0.158415869f,
+    -0.995419204f, -0.00865581911f, 0.0952140316f, -0.55249238f, 0.471639812f, 0.68724668f,
+    -0.638865292f, 0.385981113f, 0.665484667f, -0.532670677f, 0.279018015f, 0.799006104f,
+    -0.978186369f, 0.0889260396f, 0.187732756f, -0.919530511f, 0.087574333f, 0.383137733f,
+    -0.3802329f, 0.0f, 0.924890816f, -0.372629553f, 0.264446795f, 0.889502764f,
+    -0.924890816f, 0.0f, 0.380232871f, 0.0f, 0.113300785f, 0.993560672f,
+};
+
+inline constexpr int SUBMARINE_INDICES[SUBMARINE_TRIANGLE_COUNT * 3] = {
+    0, 1, 2, 3, 2, 1, 1, 4, 3, 0, 5, 1,
+    1, 5, 4, 6, 0, 2, 6, 2, 7, 3, 7, 2,
+    4, 8, 3, 8, 7, 3, 9, 10, 4, 11, 4, 5,
+    4, 10, 8, 11, 9, 4, 0, 12, 5, 11, 5, 12,
+    13, 9, 11, 11, 12, 14, 13, 11, 15, 15, 11, 14,
+    16, 9, 17, 9, 18, 10, 16, 18, 9, 13, 17, 9,
+    13, 15, 19, 20, 17, 13, 20, 13, 19, 15, 21, 22,
+    23, 15, 22, 15, 14, 24, 15, 24, 21, 23, 19, 15,
+    24, 14, 12, 24, 12, 25, 26, 24, 25, 26, 21, 24,
+    22, 21, 26, 22, 26, 27, 28, 22, 27, 28, 29, 22,
+    23, 22, 29, 23, 29, 30, 30, 31, 23, 19, 23, 31,
+    32, 29, 28, 33, 29, 34, 32, 34, 29, 33, 30, 29,
+    35, 28, 36, 6, 28, 27, 35, 32, 28, 6, 36, 28,
+    6, 27, 0, 0, 27, 26, 0, 26, 25, 0, 25, 12,
+    6, 7, 36, 36, 37, 35, 36, 7, 37, 32, 35, 38,
+    38, 35, 37, 38, 37, 39, 40, 37, 8, 8, 37, 7,
+    40, 39, 37, 32, 38, 41, 42, 38, 39, 41, 38, 42,
+    43, 39, 40, 42, 39, 44, 43, 44, 39, 40, 10, 45,
+    40, 8, 10, 43, 40, 45, 46, 44, 43, 43, 45, 46,
+    44, 47, 42, 46, 48, 44, 44, 48, 47, 41, 42, 47,
+    49, 32, 41, 50, 41, 47, 50, 49, 41, 48, 51, 47,
+    50, 47, 51, 48, 52, 53, 48, 53, 51, 48, 46, 52,
+    54, 52, 46, 54, 46, 45, 54, 45, 55, 55, 45, 10,
+    55, 10, 18, 55, 56, 57, 55, 18, 56, 54, 55, 57,
+    58, 59, 54, 54, 57, 58, 54, 59, 52, 59, 53, 52,
+    53, 60, 51, 59, 61, 53, 53, 61, 60, 50, 51, 60,
+    58, 60, 61, 58, 50, 60, 57, 50, 58, 58, 61, 59,
+    57, 49, 50, 56, 49, 57, 33, 56, 62, 16, 56, 18,
+    56, 34, 49, 33, 34, 56, 16, 62, 56, 30, 33, 63,
+    63, 33, 62, 63, 62, 64, 65, 62, 16, 65, 64, 62,
+    65, 16, 17, 66, 67, 65, 65, 17, 66, 64, 65, 67,
+    64, 67, 68, 64, 69, 63, 64, 68, 69, 30, 63, 70,
+    70, 63, 69, 30, 70, 31, 70, 69, 71, 70, 72, 31,
+    70, 71, 72, 73, 71, 69, 73, 69, 68, 73, 68, 74,
+    75, 68, 67, 75, 74, 68, 66, 76, 67, 75, 67, 76,
+    75, 77, 74, 75, 76, 78, 78, 79, 75, 75, 79, 77,
+    74, 80, 73, 74, 77, 80, 73, 81, 82, 73, 82, 71,
+    73, 80, 81, 83, 71, 82, 83, 72, 71, 82, 84, 83,
+    82, 81, 84, 81, 85, 86, 84, 81, 86, 81, 80, 85,
+    80, 87, 85, 80, 77, 87, 77, 88, 87, 77, 79, 88,
+    79, 89, 88, 78, 90, 79, 79, 90, 89, 89, 91, 88,
+    87, 88, 91, 87, 91, 92, 85, 87, 92, 85, 92, 93,
+    86, 85, 93, 84, 86, 94, 86, 93, 95, 94, 86, 95,
+    83, 84, 96, 96, 84, 94, 96, 94, 97, 94, 95, 98,
+    97, 94, 98, 95, 99, 100, 98, 95, 100, 95, 93, 99,
+    93, 101, 99, 93, 92, 101, 91, 101, 92, 99, 101, 102,
+    91, 102, 101, 103, 102, 91, 89, 103, 91, 102, 104, 105,
+    103, 106, 102, 102, 106, 104, 99, 102, 105, 105, 100, 99,
+    98, 100, 105, 97, 98, 107, 98, 108, 107, 98, 105, 108,
+    104, 108, 105, 107, 104, 109, 109, 104, 106, 107, 108, 104,
+    109, 106, 103, 110, 103, 89, 110, 109, 103, 97, 109, 110,
+    97, 107, 109, 111, 97, 110, 90, 110, 89, 90, 111, 110,
+    112, 111, 113, 111, 96, 97, 113, 111, 90, 112, 96, 111,
+    113, 90, 78, 113, 114, 112, 113, 76, 115, 113, 115, 114,
+    113, 78, 76, 83, 96, 112, 83, 112, 114, 116, 72, 114,
+    83, 114, 72, 116, 114, 115, 66, 115, 76, 116, 115, 20,
+    66, 20, 115, 20, 19, 116, 19, 31, 116, 116, 31, 72,
+    20, 66, 17, 49, 34, 32,
+};
+
+inline constexpr int SUBMARINE_NORMAL_INDICES[SUBMARINE_TRIANGLE_COUNT * 3] = {
+    0, 0, 0, 1, 1, 1, 2, 2, 2, 0, 0, 0,
+    2, 2, 2, 0, 0, 0, 1, 1, 1, 1, 1, 1,
+    2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 3, 3, 3, 4, 4, 4,
+    5, 5, 5, 4, 4, 4, 6, 6, 6, 7, 7, 7,
+    5, 5, 5, 2, 2, 2, 8, 8, 8, 5, 5, 5,
+    6, 6, 6, 9, 9, 9, 10, 10, 10, 7, 7, 7,
+    6, 6, 6, 7, 7, 7, 7, 7, 7, 6, 6, 6,
+    11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11,
+    12, 12, 12, 12, 12, 12, 13, 13, 13, 13, 13, 13,
+    14, 14, 14, 14, 14, 14, 15, 15, 15, 10, 10, 10,
+    13, 13, 13, 16, 16, 16, 13, 13, 13, 14, 14, 14,
+    13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13, 13,
+    0, 0, 0, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 17, 17, 17,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 18, 18, 18, 1, 1, 1, 19, 19, 19,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 20, 20, 20,
+    21, 21, 21, 22, 22, 22, 23, 23, 23, 24, 24, 24,
+    23, 23, 23, 23, 23, 23, 23, 23, 23, 25, 25, 25,
+    26, 26, 26, 26, 26, 26, 26, 26, 26, 27, 27, 27,
+    28, 28, 28, 27, 27, 27, 27, 27, 27, 27, 27, 27,
+    29, 29, 29, 30, 30, 30, 30, 30, 30, 30, 30, 30,
+    30, 30, 30, 31, 31, 31, 31, 31, 31, 32, 32, 32,
+    33, 33, 33, 32, 32, 32, 29, 29, 29, 34, 34, 34,
+    34, 34, 34, 34, 34, 34, 34, 34, 34, 28, 28, 28,
+    33, 33, 33, 33, 33, 33, 32, 32, 32, 33, 33, 33,
+    32, 32, 32, 31, 31, 31, 35, 35, 35, 35, 35, 35,
+    31, 31, 31, 35, 35, 35, 35, 35, 35, 36, 36, 36,
+    37, 37, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+    39, 39, 39, 40, 40, 40, 41, 41, 41, 42, 42, 42,
+    42, 42, 42, 42, 42, 42, 42, 42, 42, 43, 43, 43,
+    44, 44, 44, 43, 43, 43, 44, 44, 44, 44, 44, 44,
+    44, 44, 44, 45, 45, 45, 45, 45, 45, 45, 45, 45,
+    45, 45, 45, 45, 45, 45, 40, 40, 40, 45, 45, 45,
+    46, 46, 46, 45, 45, 45, 47, 47, 47, 46, 46, 46,
+    48, 48, 48, 48, 48, 48, 49, 49, 49, 45, 45, 45,
+    49, 49, 49, 45, 45, 45, 45, 45, 45, 50, 50, 50,
+    50, 50, 50, 51, 51, 51, 52, 52, 52, 53, 53, 53,
+    54, 54, 54, 55, 55, 55, 56, 56, 56, 57, 57, 57,
+    58, 58, 58, 47, 47, 47, 59, 59, 59, 60, 60, 60,
+    61, 61, 61, 62, 62, 62, 63, 63, 63, 64, 64, 64,
+    65, 65, 65, 66, 66, 66, 67, 67, 67, 68, 68, 68,
+    69, 69, 69, 70, 70, 70, 71, 71, 71, 72, 72, 72,
+    73, 73, 73, 74, 74, 74, 75, 75, 75, 76, 76, 76,
+    77, 77, 77, 78, 78, 78, 79, 79, 79, 80, 80, 80,
+    81, 81, 81, 82, 82, 82, 83, 83, 83, 80, 80, 80,
+    84, 84, 84, 80, 80, 80, 80, 80, 80, 80, 80, 80,
+    85, 85, 85, 86, 86, 86, 87, 87, 87, 88, 88, 88,
+    80, 80, 80, 89, 89, 89, 90, 90, 90, 91, 91, 91,
+    92, 92, 92, 93, 93, 93, 94, 94, 94, 95, 95, 95,
+    96, 96, 96, 97, 97, 97, 98, 98, 98, 99, 99, 99,
+    100, 100, 100, 101, 101, 101, 102, 102, 102, 100, 100, 100,
+    102, 102, 102, 45, 45, 45, 45, 45, 45, 45, 45, 45,
+    45, 45, 45, 69, 69, 69, 45, 45, 45, 103, 103, 103,
+    45, 45, 45, 103, 103, 103, 40, 40, 40, 103, 103, 103,
+    40, 40, 40, 10, 10, 10, 10, 10, 10, 103, 103, 103,
+    41, 41, 41, 26, 26, 26,
+};
+
+inline constexpr glm::vec4 SUBMARINE_FACE_PLANES[SUBMARINE_TRIANGLE_COUNT] = {
+    {0.0f, -0.0651029274f, 0.195796534f, -0.172693938f},
+    {0.0f, -0.433465838f, 0.0f, -0.268586695f},
+    {-0.343741059f, 0.0f, 0.0f, -0.170800462f},
+    {0.0f, -0.0651029274f, 0.195796534f, -0.172693938f},
+    {-0.395368069f, 0.0f, 0.0f, -0.196453258f},
+    {0.0f, -0.0651009381f, 0.195790574f, -0.172688663f},
+    {-0.0f, -0.433452636f, 0.0f, -0.268578529f},
+    {0.0f, -0.433465838f, 0.0f, -0.268586695f},
+    {-0.343741089f, -0.0f, 0.0f, -0.170800477f},
+    {0.0f, -0.433465898f, 0.0f, -0.268586725f},
+    {-0.343710244f, -0.0f, 0.0f, -0.170785144f},
+    {-0.395332605f, -0.0f, 0.0f, -0.19643563f},
+    {-0.343741089f, 0.0f, -0.0f, -0.170800477f},
+    {-0.395332605f, 0.0f, -0.0f, -0.19643563f},
+    {0.0f, -0.284904301f, 0.215557292f, -0.238224864f},
+    {-0.225910574f, 0.0f, 0.0759145319f, -0.173514992f},
+    {-0.178105548f, 0.129845753f, 0.0f, -0.110366881f},
+    {-0.138313398f, 0.0f, 0.0464785583f, -0.10623429f},
+    {0.0f, 0.138388485f, 0.0882024914f, -0.0944866538f},
+    {0.0f, 0.284904301f, -0.139643699f, 0.0647089183f},
+    {-0.0973637104f, 0.0720988661f, -0.000436936971f, -0.0606074147f},
+    {-0.556275964f, 0.0f, -0.0f, -0.276406288f},
+    {-0.0765482262f, 0.124121435f, 0.0346703827f, -0.0521320589f},
+    {-0.103112742f, 0.0761587992f, -0.000241373375f, -0.0641094074f},
+    {7.8265206e-05f, 0.101815447f, 0.0647892356f, -0.0694325715f},
+    {-0.131768927f, 0.0421463288f, -0.000745611265f, -0.0626075864f},
+    {-0.000236056745f, 0.0317784101f, 0.0863985941f, -0.0567407571f},
+    {0.0f, 0.284895629f, -0.139639452f, 0.0647069514f},
+    {0.0f, 0.138384283f, 0.0881998092f, -0.0944837853f},
+    {0.0f, 0.174430862f, -0.0854959711f, 0.0396176204f},
+    {0.0f, 0.17442216f, -0.0854917094f, 0.0396156535f},
+    {-7.8265206e-05f, 0.101811238f, 0.0647865608f, -0.0694296956f},
+    {0.0f, 0.0f, 0.0733868182f, -0.101300888f},
+    {0.0f, 0.0f, 0.0733868182f, -0.101300888f},
+    {0.0f, 0.0f, 0.0733831599f, -0.101295836f},
+    {0.0f, -0.0f, 0.0733831599f, -0.101295836f},
+    {0.138313398f, 0.0f, 0.0464785658f, -0.106234297f},
+    {0.225910574f, 0.0f, 0.0759145468f, -0.173515007f},
+    {0.395332605f, 0.0f, 0.0f, -0.19643563f},
+    {0.395332605f, 0.0f, 0.0f, -0.19643563f},
+    {0.178105548f, 0.129845813f, 0.0f, -0.110366896f},
+    {0.103112742f, 0.0761588067f, -0.000241367845f, -0.0641094074f},
+    {0.131768927f, 0.0421463177f, -0.000745604746f, -0.0626075789f},
+    {0.000236055363f, 0.0317771025f, 0.0863950253f, -0.0567384176f},
+    {0.343710244f, 0.0f, 0.0f, -0.170785144f},
+    {0.0765482262f, 0.124121457f, 0.0346703902f, -0.0521320626f},
+    {0.556276023f, 0.0f, 0.0f, -0.276406318f},
+    {0.0973637104f, 0.072098881f, -0.000436936738f, -0.0606074184f},
+    {0.343741089f, 0.0f, 0.0f, -0.170800477f},
+    {0.395368069f, -0.0f, 0.0f, -0.196453258f},
+    {0.343741089f, 0.0f, 0.0f, -0.170800477f},
+    {0.343741059f, 0.0f, 0.0f, -0.170800462f},
+    {0.0f, -0.0651009381f, 0.195790574f, -0.172688663f},
+    {0.0f, -0.284895629f, 0.215550736f, -0.238217622f},
+    {0.0f, -0.17442216f, 0.131967008f, -0.1458444f},
+    {0.0f, -0.174430862f, 0.131973594f, -0.145851672f},
+    {0.0f, -0.433452636f, -0.0f, -0.268578529f},
+    {0.0f, -0.433452696f, -0.0f, -0.268578559f},
+    {-0.0f, -0.433452696f, 0.0f, -0.268578559f},
+    {0.017537849f, 0.0f, -0.0175194126f, -0.0274376757f},
+    {0.0f, -0.022114981f, 0.0f, -0.0137030166f},
+    {0.0f, -0.0201361254f, 0.0f, -0.0124768661f},
+    {0.0f, -0.0221156552f, 0.0f, -0.0137034347f},
+    {0.0f, -0.433465898f, 0.0f, -0.268586725f},
+    {0.0f, -0.0201368015f, 0.0f, -0.0124772852f},
+    {0.0639911294f, -0.00524148578f, -0.0175194126f, -0.0517021082f},
+    {0.0f, -0.0953695178f, 0.0f, -0.0590934306f},
+    {0.0830634534f, -0.0248541217f, -0.083073698f, -0.145460278f},
+    {0.0f, -0.0953727216f, 0.0f, -0.0590954162f},
+    {0.0f, -0.0509276763f, 0.0f, -0.0315561108f},
+    {0.0f, -0.0509308726f, 0.0f, -0.0315580927f},
+    {-0.0639911294f, -0.00524147879f, -0.0175193883f, -0.0517020822f},
+    {-0.017537849f, 0.0f, -0.0175193883f, -0.0274376497f},
+    {-0.0830634534f, -0.0248541255f, -0.0830737054f, -0.145460293f},
+    {0.0f, -0.163599774f, -0.0952034444f, -0.22742261f},
+    {-0.303425997f, -0.142755762f, -0.0830737054f, -0.27175498f},
+    {0.0f, -0.163589507f, -0.0951974615f, -0.22740832f},
+    {0.0f, -0.163599774f, -0.0952034444f, -0.22742261f},
+    {0.0f, -0.163589507f, -0.0951974615f, -0.22740832f},
+    {0.303425997f, -0.142755747f, -0.083073698f, -0.27175492f},
+    {0.0835154057f, 0.0f, -0.0228647441f, -0.0659337342f},
+    {0.303398788f, 0.0f, -0.0830662474f, -0.239529818f},
+    {0.396004021f, 0.0f, -0.108420238f, -0.312640578f},
+    {0.0f, -0.0638981983f, -0.045209609f, -0.104885951f},
+    {0.104209132f, 0.0f, -0.0557200573f, -0.136681482f},
+    {0.0f, -0.0264985804f, -0.0187484231f, -0.0434962027f},
+    {0.0f, -0.0264945682f, -0.0187455844f, -0.0434896164f},
+    {-0.0f, -0.0639022067f, -0.0452124476f, -0.104892537f},
+    {-0.104209132f, -0.0f, -0.0557200573f, -0.136681482f},
+    {-0.303398788f, -0.0f, -0.0830662549f, -0.239529833f},
+    {-0.396004021f, 0.0f, -0.108420253f, -0.312640607f},
+    {-0.0835154057f, -0.0f, -0.0228647124f, -0.0659336969f},
+    {-0.103556804f, 0.0f, -0.0283516143f, -0.0817559659f},
+    {0.0f, 0.0734740421f, -0.0558346733f, -0.0899495333f},
+    {0.0f, 0.0806943774f, -0.0613215752f, -0.0987889245f},
+    {0.0f, 0.348391026f, -0.0544099733f, -0.16755864f},
+    {0.0f, 0.0639022067f, -0.0105059743f, -0.0317864604f},
+    {0.0f, 0.186047539f, -0.0290559754f, -0.0894795507f},
+    {-0.0432146043f, 0.0f, -0.0231066123f, -0.0566805974f},
+    {0.0f, 0.0f, -0.0163698662f, -0.0370882563f},
+    {0.0f, 0.0f, -0.0163673889f, -0.0370826423f},
+    {0.0f, 0.0f, -0.0163698662f, -0.0370882563f},
+    {0.0f, 0.0f, -0.0163673889f, -0.0370826423f},
+    {0.0432146043f, 0.0f, -0.0231066123f, -0.0566805974f},
+    {0.0f, 0.0264945682f, -0.00435589394f, -0.013179021f},
+    {0.0f, 0.0638981983f, -0.0105053149f, -0.0317844674f},
+    {0.0f, 0.186035857f, -0.0290541518f, -0.089473933f},
+    {0.0f, 0.0264985804f, -0.00435655378f, -0.0131810177f},
+    {0.0f, 0.348379314f, -0.0544081442f, -0.167553008f},
+    {0.0f, 0.073471576f, -0.0558327958f, -0.0899465084f},
+    {0.000498982787f, 0.180548415f, 0.0188064612f, -0.0543033183f},
+    {0.0f, 0.251703233f, 0.0267051104f, -0.0751840398f},
+    {0.0f, 0.0806919187f, -0.0613197051f, -0.098785907f},
+    {0.0f, 0.251695544f, 0.0267042983f, -0.0751817375f},
+    {-0.000498982787f, 0.180556148f, 0.018807264f, -0.0543056391f},
+    {0.119221166f, 0.0349675938f, -0.00133894256f, -0.0555593781f},
+    {-0.000423587859f, 0.0790429264f, -0.078832373f, -0.0724914819f},
+    {0.0f, 0.0644308329f, -0.0647156909f, -0.0593459383f},
+    {0.000423587859f, 0.0790463239f, -0.0788357556f, -0.0724946037f},
+    {0.0f, 0.0644341782f, -0.0647190586f, -0.0593490228f},
+    {-0.119221166f, 0.0349675938f, -0.00133894198f, -0.0555593781f},
+    {-0.136096299f, 0.011175531f, 0.0f, -0.04621296f},
+    {-0.0899847075f, 0.0277285744f, 0.0f, -0.042368196f},
+    {0.0f, 0.0111720469f, -0.101710208f, -0.0409474522f},
+    {0.0f, 0.0100767817f, -0.0917389244f, -0.0369331203f},
+    {0.0f, 0.0111714657f, -0.101704918f, -0.0409453213f},
+    {0.0f, 0.0100762006f, -0.0917336345f, -0.0369309895f},
+    {0.0899847075f, 0.0277285725f, 0.0f, -0.0423681885f},
+    {0.136096299f, 0.011175531f, 0.0f, -0.0462129563f},
+    {0.0899847373f, 0.0277285837f, 0.0f, -0.0423682034f},
+    {0.12275809f, 0.0100802658f, 0.0f, -0.0416838266f},
+    {0.136096343f, 0.0111755347f, -0.0f, -0.0462129712f},
+    {0.12275809f, 0.0100802658f, 0.0f, -0.0416838266f},
+    {-0.0f, 0.0625114962f, 0.0f, -0.0580892302f},
+    {0.0f, 0.0701526552f, 0.0f, -0.065189831f},
+    {0.0f, 0.0198141169f, 0.0f, -0.0184124019f},
+    {0.0f, 0.0701566935f, 0.0f, -0.0651935786f},
+    {0.0f, 0.019817628f, 0.0f, -0.0184156634f},
+    {-0.12275809f, 0.0100802658f, 0.0f, -0.0416838303f},
+    {0.0f, 0.0625114888f, 0.0f, -0.0580892228f},
+    {-0.00614442397f, 0.0f, -0.0148317125f, -0.00103192753f},
+    {0.0f, 0.0121738035f, 0.0f, -0.011312589f},
+    {-0.0148274424f, 0.0f, -0.00614340417f, -0.00148132886f},
+    {-0.00614442397f, 0.0f, -0.0148317125f, -0.00103192753f},
+    {0.00614442397f, 0.0f, -0.0148290852f, -0.00103183778f},
+    {0.00614442397f, 0.0f, -0.0148290852f, -0.00103183778f},
+    {0.0148274424f, 0.0f, -0.00614340417f, -0.00148132816f},
+    {0.0f, 0.0121738054f, 0.0f, -0.0113125909f},
+    {0.0148274424f, 0.0f, -0.00614340417f, -0.00148132816f},
+    {0.0f, 0.0121738054f, 0.0f, -0.0113125909f},
+    {-0.0f, 0.0625114962f, 0.0f, -0.0580892302f},
+    {0.0148274424f, 0.0f, 0.00614340417f, -0.00211729272f},
+    {0.0148274424f, -0.0f, 0.00614340417f, -0.00211729272f},
+    {0.0175241549f, -0.000521222304f, -0.00390419411f, -0.00135003973f},
+    {0.016946068f, 0.00195295713f, 0.00702120736f, -0.0045721652f},
+    {0.0129485819f, -0.00240727421f, -0.00536494236f, 0.00135942083f},
+    {0.00751402043f, -0.00343308225f, -0.0113581363f, 0.00275233365f},
+    {0.00438222568f, -0.00457423739f, -0.0105761578f, 0.00430532917f},
+    {-0.00247848011f, -0.003699566f, -0.0113647515f, 0.00328654097f},
+    {-0.00464636786f, -0.00483101141f, -0.01121563f, 0.00454389257f},
+    {-0.0112347929f, -0.00214116578f, -0.00726802833f, 0.00114843692f},
+    {-0.0148274424f, 0.0f, -0.00614340417f, -0.00148132886f},
+    {-0.014490515f, -0.00285712443f, -0.00600380637f, 0.00170115114f},
+    {-0.0124478647f, -0.00322234258f, -0.0075722998f, 0.00236682501f},
+    {-0.00301551027f, -0.00699350191f, -0.0127638076f, 0.00717415987f},
+    {-9.32309777e-05f, -0.00562281907f, -0.0132350922f, 0.00537977787f},
+    {0.00776990596f, -0.00528423488f, -0.0106277457f, 0.00509877829f},
+    {0.00945075322f, -0.00480346009f, -0.0111309364f, 0.00429504132f},
+    {0.0162414256f, -0.00162444892f, -0.00293752714f, 0.000227512253f},
+    {0.018348299f, 0.00454848632f, 0.0112795439f, -0.00813872926f},
+    {0.0174191631f, 0.000195279834f, -0.00155721756f, -0.00228489586f},
+    {0.0172821749f, 0.00577770593f, 0.00977987237f, -0.00960108638f},
+    {0.00614446495f, -0.0f, 0.0148290852f, -0.00256694714f},
+    {0.00838087313f, 0.00611530896f, 0.020226445f, -0.0102408864f},
+    {0.00482533686f, 0.00782509148f, 0.0219264366f, -0.0124194669f},
+    {0.0152369365f, 0.0091794366f, 0.0125984969f, -0.0142264087f},
+    {0.00483105611f, 0.0125127416f, 0.0199498329f, -0.0185441021f},
+    {0.0222098939f, -0.00316752261f, 0.00563360099f, 0.00290923798f},
+    {0.0130716218f, 0.00927171297f, 0.0082855802f, -0.01453075f},
+    {0.0115265697f, -0.00238195038f, 0.00312877866f, 0.00263543171f},
+    {0.0099075269f, -0.0132216103f, -5.06397337e-05f, 0.0177513156f},
+    {0.00540949963f, -0.00686773844f, -0.000148836756f, 0.00917644706f},
+    {-0.000461190357f, -0.00908452831f, -0.000676059222f, 0.0123196505f},
+    {0.000937758014f, -0.000285784365f, -0.011598235f, -0.00280654128f},
+    {-0.00174497929f, -0.0132626891f, -0.00208565826f, 0.0177301578f},
+    {-0.00705905072f, -0.00767913228f, 0.000352035975f, 0.0101897931f},
+    {-0.0120794009f, -0.00719592348f, -0.0101515641f, 0.00738645205f},
+    {0.00450495817f, -0.00134667382f, -0.0559910461f, -0.0135965161f},
+    {-0.0147208516f, -0.0110087041f, -0.000662758946f, 0.0138834985f},
+    {0.000934748328f, -0.000278542982f, -0.011597855f, -0.00281677581f},
+    {0.00452124048f, -0.00135630765f, -0.0559927188f, -0.0135821784f},
+    {0.000941787963f, -0.000279542408f, -0.011596581f, -0.00281573716f},
+    {0.0212929789f, 0.0169893466f, 0.0136676775f, -0.0266006663f},
+    {0.000426903367f, 0.0140586793f, 0.0201649424f, -0.0207525007f},
+    {0.000903469801f, 0.0210519135f, 0.0125761172f, -0.0321225896f},
+    {0.00268756226f, 0.0279837381f, 0.0161704421f, -0.0427957214f},
+    {0.000933260075f, -0.000280236593f, -0.0115949512f, -0.00281338999f},
+    {-0.0143485768f, 0.0125801638f, 0.00891082734f, -0.0198528599f},
+    {-0.0249983184f, 0.00370831601f, 0.00532208988f, -0.00804139674f},
+    {-0.0182873197f, 0.0233181268f, 0.0131781483f, -0.0365858637f},
+    {-0.0148648936f, -0.00145853101f, 0.00345989782f, 0.000782745949f},
+    {-0.017861953f, 0.00213439716f, 0.00301963906f, -0.00478746556f},
+    {-0.0207304768f, -0.000254282961f, 0.00188074389f, -0.00187798962f},
+    {-0.0122867748f, 0.0105078593f, 0.0154441558f, -0.0158570465f},
+    {-0.015661316f, 0.00945407711f, 0.0161882937f, -0.0145911947f},
+    {-0.0116976351f, 0.00617149426f, 0.017175734f, -0.010167785f},
+    {-0.0169682391f, 0.00154082652f, 0.00315893954f, -0.00392073952f},
+    {-0.0184880011f, 0.00173545606f, 0.00766007137f, -0.00455264095f},
+    {-0.00614446495f, 0.0f, 0.0148317125f, -0.00256730872f},
+    {-0.0086450167f, 0.00610007299f, 0.0208676253f, -0.0103349537f},
+    {-0.0148274424f, 0.0f, 0.00614340417f, -0.00211729365f},
+    {-0.00614446495f, 0.0f, 0.0148317125f, -0.00256730872f},
+    {-0.0148274424f, 0.0f, 0.00614340417f, -0.00211729365f},
+    {0.0f, 0.0198176056f, 0.0f, -0.0184156429f},
+    {0.0f, 0.0625114888f, 0.0f, -0.0580892228f},
+    {0.0f, 0.0701566935f, -0.0f, -0.0651935786f},
+    {0.0f, 0.0121738035f, 0.0f, -0.011312589f},
+    {0.00614446495f, 0.0f, 0.0148290852f, -0.00256694714f},
+    {0.0f, 0.0198140964f, 0.0f, -0.0184123833f},
+    {0.0f, 0.0100762323f, 0.0917336345f, -0.046427276f},
+    {0.0f, 0.0701526552f, -0.0f, -0.065189831f},
+    {0.0f, 0.0100768125f, 0.0917389244f, -0.0464299545f},
+    {-0.12275809f, 0.0100802658f, 0.0f, -0.0416838303f},
+    {0.0f, 0.0111720813f, 0.101710208f, -0.0514765158f},
+    {-0.136096343f, 0.0111755347f, 0.0f, -0.0462129787f},
+    {-0.0f, 0.0255755242f, 0.0689014718f, -0.04533007f},
+    {0.0f, 0.0255741943f, 0.0688978955f, -0.0453277156f},
+    {-0.0f, 0.0111715011f, 0.101704918f, -0.0514738411f},
+    {-0.0899847373f, 0.0277285818f, 0.0f, -0.0423682071f},
+    {0.103556804f, 0.0f, -0.0283516534f, -0.0817560107f},
+};
+
+inline constexpr MeshMaterialRange SUBMARINE_MATERIAL_RANGES[SUBMARINE_RANGE_COUNT] = {
+    {{1.0f, 1.0f, 1.0f}, {0.800000012f, 0.800000012f, 0.800000012f}, {0.5f, 0.5f, 0.5f}, 250.0f, 0, 0, 230},
+};
+
+inline constexpr EmbeddedMesh SUBMARINE_MESH{
+    SUBMARINE_POSITIONS, SUBMARINE_NORMALS, SUBMARINE_INDICES, SUBMARINE_NORMAL_INDICES,
+    SUBMARINE_FACE_PLANES, SUBMARINE_MATERIAL_RANGES,
+    SUBMARINE_VERTEX_COUNT, SUBMARINE_NORMAL_COUNT, SUBMARINE_TRIANGLE_COUNT, SUBMARINE_RANGE_COUNT,
+    {0.0f, 0.539727449f, -0.44263649f}, 1.91511858f
+};
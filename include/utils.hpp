@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
 #include "pd_api.h"
 
 #define samplepixel(data, x, y, rowbytes) (((data[(y)*rowbytes+(x)/8] & (1 << (uint8_t)(7 - ((x) % 8)))) != 0) ? kColorWhite : kColorBlack)
@@ -30,4 +31,7 @@ bool bad_float(float f);
 
 float clamp_to_screen_x(float f);
 
-std::vector<std::vector<int>> bayerMatrix(int n);
\ No newline at end of file
+constexpr uint32_t FNV1A_SEED = 2166136261u;
+
+// 32-bit FNV-1a, pass the previous result as i_hash to hash data in pieces
+uint32_t fnv1a_hash(const void* i_data, size_t i_size, uint32_t i_hash = FNV1A_SEED);
\ No newline at end of file
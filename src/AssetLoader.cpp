@@ -0,0 +1,184 @@
+#include "AssetLoader.hpp"
+#include <unordered_set>
+#include "WFObjLoader.hpp"
+#include "BinaryMeshLoader.hpp"
+#include "ScreenGlobals.hpp"
+
+AssetLoader::AssetLoader() {}
+AssetLoader::~AssetLoader() {}
+
+std::shared_ptr<MeshHandle> AssetLoader::load_mesh(std::string i_filepath, int i_lod_count) {
+    auto cached = m_cache.find(i_filepath);
+    if (cached != m_cache.end() && !cached->second->m_failed
+        && cached->second->m_lod_count >= i_lod_count) {
+        return cached->second;
+    }
+
+    std::shared_ptr<MeshHandle> handle = std::make_shared<MeshHandle>();
+    handle->m_filepath = i_filepath;
+    handle->m_lod_count = i_lod_count;
+    m_queue.push_back(handle);
+    m_queued_count++;
+    m_cache[i_filepath] = handle;
+    return handle;
+}
+
+bool AssetLoader::update(PlaydateAPI* pd, unsigned int i_budget_ms) {
+    unsigned int start_ms = pd->system->getCurrentTimeMilliseconds();
+    while (!m_queue.empty()) {
+        step(pd);
+        if (pd->system->getCurrentTimeMilliseconds() - start_ms >= i_budget_ms) break;
+    }
+    return !m_queue.empty();
+}
+
+float AssetLoader::get_progress() {
+    if (m_queued_count == 0) return 1.0f;
+    float current = m_queue.empty() ? 0.0f : m_queue.front()->m_progress;
+    return (m_completed_count + current) / m_queued_count;
+}
+
+bool AssetLoader::is_idle() {
+    return m_queue.empty();
+}
+
+void AssetLoader::step(PlaydateAPI* pd) {
+    MeshHandle& handle = *m_queue.front();
+
+    switch (m_stage) {
+        case LoadStage::Open: {
+            m_start_ms = pd->system->getCurrentTimeMilliseconds();
+            const std::string& path = handle.m_filepath;
+            bool is_binary = path.size() >= 5 && path.compare(path.size() - 5, 5, ".mesh") == 0;
+            if (is_binary) {
+                m_file_loader = std::make_unique<BinaryMeshLoader>();
+            } else {
+                m_file_loader = std::make_unique<WFObjLoader>();
+            }
+            if (!m_file_loader->begin_load(path, pd)) {
+                complete(pd, true);
+                return;
+            }
+            m_stage = LoadStage::Parse;
+            break;
+        }
+        case LoadStage::Parse: {
+            /* Parsing is most of the work, LODs share the last tenth */
+            bool parsed = m_file_loader->continue_load(pd);
+            handle.m_progress = m_file_loader->get_load_progress() * 0.9f;
+            if (!parsed) return;
+
+            handle.m_content_fingerprint = m_file_loader->get_content_fingerprint();
+            if (share_cached_mesh(handle)) {
+                complete(pd, false);
+                return;
+            }
+            handle.m_vertex_data = m_file_loader->finish_load(pd);
+            m_file_loader = nullptr;
+            if (handle.m_vertex_data == nullptr) {
+                complete(pd, true);
+                return;
+            }
+            m_lods_built = 0;
+            m_stage = LoadStage::Lods;
+            break;
+        }
+        case LoadStage::Lods: {
+            float triangle_ratio = SceneObject::get_lod_triangle_ratio(m_lods_built);
+            if (m_lods_built >= handle.m_lod_count
+                || handle.m_vertex_data->triangle_count() * triangle_ratio < LOD_MIN_TRIANGLES) {
+                complete(pd, false);
+                return;
+            }
+            handle.m_lods.push_back(handle.m_vertex_data->create_lod(triangle_ratio));
+            handle.m_lod_screen_radii.push_back(SceneObject::get_lod_screen_radius(m_lods_built));
+            m_lods_built++;
+            handle.m_progress = 0.9f + 0.1f * m_lods_built / handle.m_lod_count;
+            break;
+        }
+    }
+}
+
+void AssetLoader::complete(PlaydateAPI* pd, bool i_failed) {
+    std::shared_ptr<MeshHandle> handle = m_queue.front();
+    m_queue.pop_front();
+    m_file_loader = nullptr;
+    m_stage = LoadStage::Open;
+    m_completed_count++;
+
+    handle->m_progress = 1.0f;
+    handle->m_failed = i_failed;
+    handle->m_ready = !i_failed;
+    if (i_failed) {
+        pd->system->logToConsole("Failed to load %s", handle->m_filepath.c_str());
+    } else {
+        if (m_cache_by_hash[handle->m_content_fingerprint.m_hash].expired()) {
+            m_cache_by_hash[handle->m_content_fingerprint.m_hash] = handle;
+        }
+        pd->system->logToConsole("Loaded %s in %u ms", handle->m_filepath.c_str(),
+            pd->system->getCurrentTimeMilliseconds() - m_start_ms);
+    }
+}
+
+bool AssetLoader::share_cached_mesh(MeshHandle& i_handle) {
+    auto found = m_cache_by_hash.find(i_handle.m_content_fingerprint.m_hash);
+    if (found == m_cache_by_hash.end()) return false;
+    std::shared_ptr<MeshHandle> source = found->second.lock();
+    if (source == nullptr || !source->m_ready || source->m_lod_count < i_handle.m_lod_count) {
+        return false;
+    }
+    /* A matching hash alone may be a collision */
+    if (source->m_content_fingerprint != i_handle.m_content_fingerprint) {
+        return false;
+    }
+
+    /* Same bytes as a mesh already in memory, reuse it and its LODs */
+    i_handle.m_vertex_data = source->m_vertex_data;
+    i_handle.m_lods = source->m_lods;
+    i_handle.m_lod_screen_radii = source->m_lod_screen_radii;
+    m_file_loader = nullptr;
+    return true;
+}
+
+int AssetLoader::purge_unused() {
+    /* A mesh is unused when only cached handles, and the cached LODs
+       borrowing its normals, still point at it */
+    std::unordered_map<const IndexedVertexData*, long> cached_references;
+    std::unordered_set<const VertexData*> counted_lods;
+    for (auto& entry : m_cache) {
+        if (entry.second->m_vertex_data != nullptr) {
+            cached_references[entry.second->m_vertex_data.get()]++;
+        }
+        /* Handles sharing a mesh share its LODs, count each LOD once */
+        for (std::shared_ptr<VertexData>& lod : entry.second->m_lods) {
+            std::shared_ptr<IndexedVertexData> indexed = std::dynamic_pointer_cast<IndexedVertexData>(lod);
+            if (indexed == nullptr || indexed->get_normal_source() == nullptr) continue;
+            if (counted_lods.insert(lod.get()).second) {
+                cached_references[indexed->get_normal_source()]++;
+            }
+        }
+    }
+
+    int purged = 0;
+    for (auto it = m_cache.begin(); it != m_cache.end();) {
+        MeshHandle& handle = *it->second;
+        bool in_flight = !handle.m_ready && !handle.m_failed;
+        bool unused = handle.m_vertex_data == nullptr
+            || handle.m_vertex_data.use_count() <= cached_references[handle.m_vertex_data.get()];
+        if (!in_flight && unused && it->second.use_count() == 1) {
+            it = m_cache.erase(it);
+            purged++;
+        } else {
+            ++it;
+        }
+    }
+
+    for (auto it = m_cache_by_hash.begin(); it != m_cache_by_hash.end();) {
+        if (it->second.expired()) {
+            it = m_cache_by_hash.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return purged;
+}
@@ -0,0 +1,214 @@
+#include "BinaryMeshLoader.hpp"
+#include <cstring>
+#include "utils.hpp"
+
+static const int MESH_STREAM_COUNT = 6;
+
+BinaryMeshLoader::BinaryMeshLoader() {}
+BinaryMeshLoader::~BinaryMeshLoader() {}
+
+bool BinaryMeshLoader::begin_load(std::string i_filepath, PlaydateAPI* pd) {
+    close(pd);
+    m_filepath = i_filepath;
+    m_streams_read = 0;
+    m_failed = false;
+
+    m_file = pd->file->open(i_filepath.c_str(), kFileRead);
+    if (m_file == NULL) {
+        pd->system->error("Couldn't open mesh %s: %s", i_filepath.c_str(), pd->file->geterr());
+        return false;
+    }
+
+    if (pd->file->read(m_file, &m_header, sizeof(m_header)) != sizeof(m_header)
+        || m_header.m_magic != MESH_FORMAT_MAGIC) {
+        pd->system->error("%s is not a mesh file", i_filepath.c_str());
+        close(pd);
+        return false;
+    }
+    if (m_header.m_version != MESH_FORMAT_VERSION) {
+        pd->system->error("%s has mesh format version %d, expected %d",
+            i_filepath.c_str(), m_header.m_version, MESH_FORMAT_VERSION);
+        close(pd);
+        return false;
+    }
+
+    /* Buffers are sized from the counts, so they must describe this file
+       exactly before anything is allocated */
+    FileStat stat;
+    if (pd->file->stat(i_filepath.c_str(), &stat) != 0 || mesh_file_size(m_header) != stat.size) {
+        pd->system->error("%s doesn't have the size its header gives", i_filepath.c_str());
+        close(pd);
+        return false;
+    }
+
+    m_content_hash = fnv1a_hash(&m_header, sizeof(m_header));
+    m_content_size = sizeof(m_header);
+
+    /* The final buffers are the only allocations, packed streams are read
+       into their tails and widened in place */
+    uint32_t index_count = m_header.m_triangle_count * 3;
+    m_vertex_buffer.resize(m_header.m_vertex_count * 3);
+    m_normal_buffer.resize(m_header.m_normal_count * 3);
+    m_index_buffer.resize(index_count);
+    m_normal_index_buffer.resize(index_count);
+    m_face_planes.resize(m_header.m_triangle_count);
+    m_material_ranges.resize(m_header.m_range_count);
+    return true;
+}
+
+bool BinaryMeshLoader::continue_load(PlaydateAPI* pd) {
+    if (m_file == nullptr) return true;
+
+    /* Everything drawing indexes with is checked against the header, so a
+       corrupt file fails here instead of reading out of bounds later */
+    bool ok = true;
+    const char* invalid = nullptr;
+    int largest_index = -1;
+    switch (m_streams_read) {
+        case 0:
+            ok = read_positions(pd);
+            break;
+        case 1:
+            ok = read_normals(pd);
+            break;
+        case 2:
+            ok = read_indices(m_index_buffer, largest_index, pd);
+            if (largest_index >= (int64_t)m_header.m_vertex_count) invalid = "a vertex index past its vertices";
+            break;
+        case 3:
+            ok = read_indices(m_normal_index_buffer, largest_index, pd);
+            if (largest_index >= (int64_t)m_header.m_normal_count) invalid = "a normal index past its normals";
+            break;
+        case 4:
+            ok = read_stream(m_face_planes.data(), m_face_planes.size() * sizeof(glm::vec4), pd);
+            break;
+        case 5:
+            ok = read_stream(m_material_ranges.data(), m_material_ranges.size() * sizeof(MeshMaterialRange), pd);
+            if (!ranges_cover_triangles()) invalid = "material ranges that don't cover its triangles in order";
+            break;
+    }
+    m_streams_read++;
+
+    if (!ok) {
+        pd->system->error("%s is truncated", m_filepath.c_str());
+        m_failed = true;
+    } else if (invalid != nullptr) {
+        pd->system->error("%s has %s", m_filepath.c_str(), invalid);
+        m_failed = true;
+    }
+    if (m_failed || m_streams_read == MESH_STREAM_COUNT) {
+        close(pd);
+        return true;
+    }
+    return false;
+}
+
+float BinaryMeshLoader::get_load_progress() {
+    return (float)m_streams_read / MESH_STREAM_COUNT;
+}
+
+ContentFingerprint BinaryMeshLoader::get_content_fingerprint() {
+    return {m_content_hash, m_content_size, m_header.m_vertex_count, m_header.m_triangle_count};
+}
+
+std::shared_ptr<IndexedVertexData> BinaryMeshLoader::finish_load([[maybe_unused]] PlaydateAPI* pd) {
+    if (m_failed || m_streams_read < MESH_STREAM_COUNT) {
+        return nullptr;
+    }
+
+    glm::vec3 bounds_center{m_header.m_sphere_center[0], m_header.m_sphere_center[1], m_header.m_sphere_center[2]};
+    int stride = 6;
+    std::shared_ptr<IndexedVertexData> vertex_data
+        = std::make_shared<IndexedVertexData>(
+            std::move(m_vertex_buffer),
+            std::move(m_index_buffer),
+            std::move(m_normal_buffer),
+            std::move(m_normal_index_buffer),
+            std::move(m_face_planes), bounds_center, m_header.m_sphere_radius, stride);
+
+    std::vector<MaterialRange> ranges = create_material_ranges(
+        m_material_ranges.data(), m_material_ranges.size(), m_header.m_triangle_count);
+    if (!ranges.empty()) {
+        vertex_data->set_material_ranges(std::move(ranges));
+    }
+
+    m_material_ranges = {};
+    return vertex_data;
+}
+
+/* A packed stream is read into the end of the buffer it widens into and
+   expanded front to back. Element i is always written below the bytes of
+   element i + 1, so nothing unread is overwritten. */
+static char* packed_tail(void* i_buffer, size_t i_buffer_size, size_t i_packed_size) {
+    return (char*)i_buffer + i_buffer_size - i_packed_size;
+}
+
+bool BinaryMeshLoader::read_positions(PlaydateAPI* pd) {
+    size_t count = m_vertex_buffer.size();
+    char* packed = packed_tail(m_vertex_buffer.data(), count * sizeof(float), count * sizeof(int16_t));
+    if (!read_stream(packed, count * sizeof(int16_t), pd)) return false;
+    for (size_t i = 0; i < count; i++) {
+        int16_t q;
+        memcpy(&q, packed + i * sizeof(int16_t), sizeof(q));
+        int axis = i % 3;
+        m_vertex_buffer[i] = dequantize_position(q, m_header.m_bounds_min[axis], m_header.m_bounds_max[axis]);
+    }
+    return true;
+}
+
+bool BinaryMeshLoader::read_normals(PlaydateAPI* pd) {
+    size_t count = m_header.m_normal_count;
+    char* packed = packed_tail(m_normal_buffer.data(), count * 3 * sizeof(float), count * 2);
+    if (!read_stream(packed, count * 2, pd)) return false;
+    for (size_t i = 0; i < count; i++) {
+        int8_t e[2] = { (int8_t)packed[i * 2], (int8_t)packed[i * 2 + 1] };
+        glm::vec3 n = decode_octahedral(e);
+        m_normal_buffer[i * 3] = n.x;
+        m_normal_buffer[i * 3 + 1] = n.y;
+        m_normal_buffer[i * 3 + 2] = n.z;
+    }
+    return true;
+}
+
+bool BinaryMeshLoader::read_indices(std::vector<int>& o_indices, int& o_largest, PlaydateAPI* pd) {
+    size_t count = o_indices.size();
+    char* packed = packed_tail(o_indices.data(), count * sizeof(int), count * sizeof(uint16_t));
+    if (!read_stream(packed, count * sizeof(uint16_t), pd)) return false;
+    int largest = -1;
+    for (size_t i = 0; i < count; i++) {
+        uint16_t index;
+        memcpy(&index, packed + i * sizeof(uint16_t), sizeof(index));
+        o_indices[i] = index;
+        largest = index > largest ? index : largest;
+    }
+    o_largest = largest;
+    return true;
+}
+
+bool BinaryMeshLoader::ranges_cover_triangles() {
+    /* No ranges at all is a mesh drawn with the default material */
+    if (m_material_ranges.empty()) return true;
+    uint64_t next_triangle = 0;
+    for (const MeshMaterialRange& range : m_material_ranges) {
+        if (range.m_first_triangle != next_triangle) return false;
+        next_triangle += range.m_triangle_count;
+    }
+    return next_triangle == m_header.m_triangle_count;
+}
+
+bool BinaryMeshLoader::read_stream(void* o_data, uint32_t i_size, PlaydateAPI* pd) {
+    if (i_size > 0 && pd->file->read(m_file, o_data, i_size) != (int)i_size) {
+        return false;
+    }
+    m_content_hash = fnv1a_hash(o_data, i_size, m_content_hash);
+    m_content_size += i_size;
+    uint32_t padding = mesh_stream_padding(i_size);
+    return padding == 0 || pd->file->seek(m_file, padding, SEEK_CUR) == 0;
+}
+
+void BinaryMeshLoader::close(PlaydateAPI* pd) {
+    if (m_file != nullptr) {
+        pd->file->close(m_file);
+        m_file = nullptr;
+    }
+}
@@ -0,0 +1,116 @@
+#include "BufferedFileReader.hpp"
+#include <cstring>
+#include <algorithm>
+
+BufferedFileReader::BufferedFileReader(PlaydateAPI* pd, int i_block_size) {
+    m_pd = pd;
+    m_block.resize(i_block_size);
+}
+
+BufferedFileReader::~BufferedFileReader() {
+    close();
+}
+
+bool BufferedFileReader::open(const char* i_filepath) {
+    close();
+    m_file = m_pd->file->open(i_filepath, kFileRead);
+    if (m_file == NULL) {
+        m_pd->system->logToConsole("Couldn't open %s: %s", i_filepath, m_pd->file->geterr());
+        return false;
+    }
+    m_position = 0;
+    m_end = 0;
+    m_block_offset = 0;
+    m_eof = false;
+    m_content_hash = FNV1A_SEED;
+    m_content_size = 0;
+    return true;
+}
+
+void BufferedFileReader::close() {
+    if (m_file != nullptr) {
+        m_pd->file->close(m_file);
+        m_file = nullptr;
+    }
+    m_eof = true;
+}
+
+bool BufferedFileReader::is_open() {
+    return m_file != nullptr;
+}
+
+bool BufferedFileReader::refill() {
+    if (m_eof) return false;
+    int read = m_pd->file->read(m_file, m_block.data(), m_block.size());
+    if (read <= 0) {
+        m_eof = true;
+        return false;
+    }
+    m_block_offset += m_end;
+    m_position = 0;
+    m_end = read;
+    m_content_hash = fnv1a_hash(m_block.data(), read, m_content_hash);
+    m_content_size += read;
+    return true;
+}
+
+bool BufferedFileReader::next_line(std::string_view& o_line) {
+    if (!next_record('\n', o_line)) return false;
+    if (!o_line.empty() && o_line.back() == '\r') {
+        o_line.remove_suffix(1);
+    }
+    return true;
+}
+
+bool BufferedFileReader::next_record(char i_delimiter, std::string_view& o_record) {
+    m_carry.clear();
+    while (true) {
+        if (m_position == m_end && !refill()) {
+            /* Last record may not be terminated */
+            o_record = m_carry;
+            return !m_carry.empty();
+        }
+        const char* start = m_block.data() + m_position;
+        int available = m_end - m_position;
+        const char* found = (const char*)memchr(start, i_delimiter, available);
+        if (found != nullptr) {
+            int length = found - start;
+            m_position += length + 1;
+            if (m_carry.empty()) {
+                /* Common case, the whole record is inside the block */
+                o_record = std::string_view(start, length);
+            } else {
+                m_carry.append(start, length);
+                o_record = m_carry;
+            }
+            return true;
+        }
+        m_carry.append(start, available);
+        m_position = m_end;
+    }
+}
+
+int BufferedFileReader::read(void* o_data, int i_size) {
+    char* out = (char*)o_data;
+    int total = 0;
+    while (total < i_size) {
+        if (m_position == m_end && !refill()) break;
+        int count = std::min(i_size - total, m_end - m_position);
+        memcpy(out + total, m_block.data() + m_position, count);
+        m_position += count;
+        total += count;
+    }
+    return total;
+}
+
+int BufferedFileReader::get_offset() {
+    return m_block_offset + m_position;
+}
+
+uint32_t BufferedFileReader::get_content_hash() {
+    return m_content_hash;
+}
+
+uint32_t BufferedFileReader::get_content_size() {
+    return m_content_size;
+}
@@ -0,0 +1,47 @@
+#include "FramePresenter.hpp"
+#include <cstring>
+#include "ScreenGlobals.hpp"
+
+FramePresenter::FramePresenter() {
+    m_rows_pushed = 0;
+}
+
+FramePresenter::~FramePresenter() {}
+
+void FramePresenter::present(PlaydateAPI* pd, LCDBitmap* i_frame_buffer) {
+    /* The frame buffer only maps 1:1 onto display rows when unscaled */
+    if (PIXEL_SCALE != 1) {
+        pd->graphics->drawBitmap(i_frame_buffer, 0, 0, kBitmapUnflipped);
+        m_rows_pushed = SCREEN_HEIGHT;
+        return;
+    }
+
+    int width, height, rowbytes;
+    uint8_t* data;
+    pd->graphics->getBitmapData(i_frame_buffer, &width, &height, &rowbytes, NULL, &data);
+    uint8_t* display = pd->graphics->getFrame();
+    const int row_size = SCREEN_WIDTH / 8;
+
+    m_rows_pushed = 0;
+    int run_start = -1;
+    for (int y = 0; y < SCREEN_HEIGHT; y++) {
+        uint8_t* src_row = &data[y * rowbytes];
+        uint8_t* dst_row = &display[y * LCD_ROWSIZE];
+        bool changed = memcmp(src_row, dst_row, row_size) != 0;
+        if (changed) {
+            memcpy(dst_row, src_row, row_size);
+            m_rows_pushed++;
+            if (run_start < 0) run_start = y;
+        } else if (run_start >= 0) {
+            pd->graphics->markUpdatedRows(run_start, y - 1);
+            run_start = -1;
+        }
+    }
+    if (run_start >= 0) {
+        pd->graphics->markUpdatedRows(run_start, SCREEN_HEIGHT - 1);
+    }
+}
+
+int FramePresenter::get_rows_pushed() {
+    return m_rows_pushed;
+}
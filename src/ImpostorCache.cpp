@@ -0,0 +1,213 @@
+#include "ImpostorCache.hpp"
+#include <glm/gtc/quaternion.hpp>
+#include <algorithm>
+#include <climits>
+#include "ScreenGlobals.hpp"
+#include "Fog.hpp"
+#include "utils.hpp"
+
+static const int IMPOSTOR_ROWBYTES = IMPOSTOR_MAX_SIZE / 8;
+
+ImpostorCache::ImpostorCache() {
+    m_impostors.resize(IMPOSTOR_CACHE_SIZE);
+    for (Impostor& impostor : m_impostors) {
+        impostor.m_bitmap.resize(IMPOSTOR_ROWBYTES * IMPOSTOR_MAX_SIZE);
+        impostor.m_mask.resize(IMPOSTOR_ROWBYTES * IMPOSTOR_MAX_SIZE);
+    }
+    m_scratch_depth.resize(IMPOSTOR_MAX_SIZE * IMPOSTOR_MAX_SIZE);
+    m_frame = 0;
+    m_cos_tolerance = cosf(glm::radians(IMPOSTOR_ANGLE_TOLERANCE_DEGREES));
+}
+
+ImpostorCache::~ImpostorCache() {}
+
+void ImpostorCache::begin_frame() {
+    m_frame++;
+}
+
+void ImpostorCache::clear() {
+    for (Impostor& impostor : m_impostors) {
+        impostor.m_object_id = 0;
+    }
+}
+
+void ImpostorCache::draw(SceneObject& i_object, const Camera& i_camera, PlaydateAPI* pd,
+    RenderTarget& target, Lighting& lighting) {
+    glm::mat4 view = i_camera.GetViewMatrix();
+    glm::mat4 projection = SceneObject::get_projection_matrix();
+
+    glm::vec3 center = i_object.get_world_bounds_center();
+    float radius = i_object.get_world_bounds_radius();
+    glm::vec4 view_center = view * glm::vec4(center, 1.0f);
+    float distance = glm::length(glm::vec3(view_center));
+
+    /* Inside opaque fog, neither the mesh nor its sprite shows */
+    if (-view_center.z - radius > FOG_END) return;
+
+    /* Bounds touching the near plane can't be represented by a flat sprite */
+    if (view_center.z > -(radius + NEAR_PLANE)) {
+        i_object.draw(i_camera, pd, target, lighting);
+        return;
+    }
+
+    float screen_radius = radius * SceneObject::get_screen_focal_length() / distance;
+    if (screen_radius > IMPOSTOR_MAX_SCREEN_RADIUS) {
+        i_object.draw(i_camera, pd, target, lighting);
+        return;
+    }
+
+    glm::vec4 clip = projection * view_center;
+    float inv_w = 1.0f / clip.w;
+    glm::vec2 screen_center{
+        (clip.x * inv_w + 1.0f) * SCREEN_WIDTH * 0.5f,
+        (1.0f - clip.y * inv_w) * SCREEN_HEIGHT * 0.5f
+    };
+    int center_depth = (int)((clip.z * inv_w * 0.5f + 0.5f) * INT16_MAX);
+
+    if (screen_center.x + screen_radius < target.m_origin_x ||
+        screen_center.x - screen_radius >= target.m_origin_x + target.m_width ||
+        screen_center.y + screen_radius < target.m_origin_y ||
+        screen_center.y - screen_radius >= target.m_origin_y + target.m_height) {
+        return;
+    }
+
+    /* Key on the view as seen from the object, so its own rotation counts */
+    glm::mat4 inv_view = glm::inverse(view);
+    glm::vec3 eye = glm::vec3(inv_view[3]);
+    glm::vec3 camera_up = glm::vec3(inv_view[1]);
+    glm::quat inv_rotation = glm::conjugate(i_object.get_transform().m_rotation);
+    glm::vec3 view_dir = inv_rotation * glm::normalize(eye - center);
+    glm::vec3 view_up = inv_rotation * glm::normalize(camera_up);
+    int distance_bucket = (int)floorf(log2f(distance) * IMPOSTOR_BUCKETS_PER_OCTAVE);
+    int fog_band = fog_factor_at_depth(-view_center.z) * IMPOSTOR_FOG_BANDS / (FOG_FACTOR_ONE + 1);
+
+
+    /* The point lights the object would be drawn with, so lights moving
+       elsewhere in the scene leave its impostor alone */
+    ImpostorLights lights;
+    lighting.prepare(view);
+    lighting.select_lights(center, radius);
+    lights.m_directional_generation = lighting.get_directional_generation();
+    lights.m_point_light_count = lighting.get_selected_light_count();
+    for (int s = 0; s < lights.m_point_light_count; s++) {
+        lights.m_point_lights[s] = lighting.get_selected_light(s);
+    }
+
+    Impostor* impostor = find(i_object.get_id(), distance_bucket, lights, fog_band,
+        view_dir, view_up);
+    if (impostor == nullptr) {
+        impostor = evict();
+        impostor->m_object_id = i_object.get_id();
+        impostor->m_distance_bucket = distance_bucket;
+        impostor->m_lights = lights;
+        impostor->m_fog_band = fog_band;
+        impostor->m_view_dir = view_dir;
+        impostor->m_view_up = view_up;
+        impostor->m_screen_center = screen_center;
+        impostor->m_screen_radius = screen_radius;
+        impostor->m_center_depth = center_depth;
+        render(*impostor, i_object, i_camera, pd, lighting);
+    }
+    impostor->m_last_used = m_frame;
+
+    blit(*impostor, screen_center, screen_radius, center_depth, target);
+}
+
+ImpostorCache::Impostor* ImpostorCache::find(int i_object_id, int i_distance_bucket,
+    const ImpostorLights& i_lights, int i_fog_band, glm::vec3 i_view_dir, glm::vec3 i_view_up) {
+    for (Impostor& impostor : m_impostors) {
+        if (impostor.m_object_id != i_object_id) continue;
+        if (impostor.m_distance_bucket != i_distance_bucket) continue;
+        if (impostor.m_fog_band != i_fog_band) continue;
+        if (impostor.m_lights != i_lights) continue;
+        if (glm::dot(impostor.m_view_dir, i_view_dir) < m_cos_tolerance) continue;
+        if (glm::dot(impostor.m_view_up, i_view_up) < m_cos_tolerance) continue;
+        return &impostor;
+    }
+    return nullptr;
+}
+
+ImpostorCache::Impostor* ImpostorCache::evict() {
+    /* Least recently used, empty slots first */
+    Impostor* oldest = &m_impostors[0];
+    for (Impostor& impostor : m_impostors) {
+        if (impostor.m_object_id == 0) return &impostor;
+        if (impostor.m_last_used < oldest->m_last_used) {
+            oldest = &impostor;
+        }
+    }
+    return oldest;
+}
+
+void ImpostorCache::render(Impostor& i_impostor, SceneObject& i_object, const Camera& i_camera,
+    PlaydateAPI* pd, Lighting& lighting) {
+    int size = std::min(IMPOSTOR_MAX_SIZE, (int)ceilf(i_impostor.m_screen_radius * 2.0f) + 2);
+    i_impostor.m_width = size;
+    i_impostor.m_height = size;
+    i_impostor.m_origin_x = (int)floorf(i_impostor.m_screen_center.x - size * 0.5f);
+    i_impostor.m_origin_y = (int)floorf(i_impostor.m_screen_center.y - size * 0.5f);
+
+    std::fill(i_impostor.m_bitmap.begin(), i_impostor.m_bitmap.end(), 0xFF);
+    std::fill(i_impostor.m_mask.begin(), i_impostor.m_mask.end(), 0);
+    std::fill(m_scratch_depth.begin(), m_scratch_depth.begin() + size * size, INT_MAX);
+
+    RenderTarget offscreen;
+    offscreen.m_data = i_impostor.m_bitmap.data();
+    offscreen.m_rowbytes = IMPOSTOR_ROWBYTES;
+    offscreen.m_depth_buffer = m_scratch_depth.data();
+    offscreen.m_width = size;
+    offscreen.m_height = size;
+    offscreen.m_origin_x = i_impostor.m_origin_x;
+    offscreen.m_origin_y = i_impostor.m_origin_y;
+    i_object.draw(i_camera, pd, offscreen, lighting);
+
+    /* Anything that got a depth value is covered by the object */
+    int nearest = INT_MAX;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            int depth = m_scratch_depth[y * size + x];
+            if (depth == INT_MAX) continue;
+            i_impostor.m_mask[y * IMPOSTOR_ROWBYTES + x / 8] |= (uint8_t)(0x80 >> (x & 7));
+            nearest = std::min(nearest, depth);
+        }
+    }
+    i_impostor.m_depth = nearest == INT_MAX ? i_impostor.m_center_depth : nearest;
+}
+
+void ImpostorCache::blit(Impostor& i_impostor, glm::vec2 i_screen_center, float i_screen_radius,
+    int i_center_depth, RenderTarget& target) {
+    /* Nearest-neighbour scale so the sprite tracks distance inside a bucket */
+    float scale = i_screen_radius / i_impostor.m_screen_radius;
+    float dest_x0 = i_screen_center.x + (i_impostor.m_origin_x - i_impostor.m_screen_center.x) * scale;
+    float dest_y0 = i_screen_center.y + (i_impostor.m_origin_y - i_impostor.m_screen_center.y) * scale;
+    float dest_w = i_impostor.m_width * scale;
+    float dest_h = i_impostor.m_height * scale;
+
+    int x_start = std::max(target.m_origin_x, (int)ceilf(dest_x0));
+    int x_end = std::min(target.m_origin_x + target.m_width - 1, (int)ceilf(dest_x0 + dest_w) - 1);
+    int y_start = std::max(target.m_origin_y, (int)ceilf(dest_y0));
+    int y_end = std::min(target.m_origin_y + target.m_height - 1, (int)ceilf(dest_y0 + dest_h) - 1);
+    if (x_start > x_end || y_start > y_end) return;
+
+    int depth = i_impostor.m_depth + (i_center_depth - i_impostor.m_center_depth);
+    int step = (int)(65536.0f / scale);
+    int sx_start = (int)((x_start - dest_x0) * 65536.0f / scale);
+
+    for (int y = y_start; y <= y_end; y++) {
+        int sy = std::min((int)((y - dest_y0) / scale), i_impostor.m_height - 1);
+        uint8_t* mask_row = &i_impostor.m_mask[sy * IMPOSTOR_ROWBYTES];
+        uint8_t* bitmap_row = &i_impostor.m_bitmap[sy * IMPOSTOR_ROWBYTES];
+        int target_y = y - target.m_origin_y;
+        int* depth_row = &target.m_depth_buffer[target_y * target.m_width - target.m_origin_x];
+
+        int sx_fixed = sx_start;
+        for (int x = x_start; x <= x_end; x++, sx_fixed += step) {
+            int sx = std::min(sx_fixed >> 16, i_impostor.m_width - 1);
+            if ((mask_row[sx / 8] & (0x80 >> (sx & 7))) == 0) continue;
+            if (depth >= depth_row[x]) continue;
+            depth_row[x] = depth;
+            int color = samplepixel(bitmap_row, sx, 0, 0);
+            drawpixel(target.m_data, x - target.m_origin_x, target_y, target.m_rowbytes, color);
+        }
+    }
+}
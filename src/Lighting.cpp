@@ -0,0 +1,128 @@
+#include "Lighting.hpp"
+#include <cmath>
+
+Lighting::Lighting() {}
+Lighting::~Lighting() {}
+
+void Lighting::set_directional_light(DirectionalLight i_light) {
+    m_directional = i_light;
+    m_directional_generation++;
+}
+
+void Lighting::set_ambient(float i_ambient) {
+    m_ambient = i_ambient;
+    m_directional_generation++;
+}
+
+void Lighting::add_point_light(PointLight i_light) {
+    m_point_lights.push_back(i_light);
+}
+
+void Lighting::set_point_light_position(int i_idx, glm::vec3 i_position) {
+    m_point_lights[i_idx].m_light_pos = glm::vec4(i_position, 1.0f);
+}
+
+void Lighting::clear_point_lights() {
+    m_point_lights.clear();
+}
+
+const std::vector<PointLight>& Lighting::get_point_lights() const {
+    return m_point_lights;
+}
+
+int Lighting::get_directional_generation() const {
+    return m_directional_generation;
+}
+
+static float attenuation(const PointLight& i_light, float i_distance) {
+    return 1.0f / (i_light.m_attenuation_constant
+        + i_light.m_attenuation_linear * i_distance
+        + i_light.m_attenuation_quadratic * i_distance * i_distance);
+}
+
+float point_light_range(const PointLight& i_light, float i_luminance) {
+    /* Solve kc + kl * d + kq * d^2 = peak / cutoff for d */
+    float peak = (i_light.m_ambientIntensity + 1.0f) * i_luminance;
+    float target = peak / LIGHT_RANGE_CUTOFF - i_light.m_attenuation_constant;
+    float kl = i_light.m_attenuation_linear;
+    float kq = i_light.m_attenuation_quadratic;
+    if (target <= 0.0f) return 0.0f;
+    if (kq > 0.0f) return (-kl + sqrtf(kl * kl + 4.0f * kq * target)) / (2.0f * kq);
+    if (kl > 0.0f) return target / kl;
+    return INFINITY;
+}
+
+void Lighting::prepare(const glm::mat4& i_view) {
+    m_view_to_light = -glm::normalize(glm::mat3(i_view) * m_directional.m_direction);
+
+    m_prepared.resize(m_point_lights.size());
+    for (size_t i = 0; i < m_point_lights.size(); i++) {
+        const PointLight& light = m_point_lights[i];
+        PreparedLight& prepared = m_prepared[i];
+        glm::vec3 color = glm::vec3(light.m_light_color) * light.m_light_color.a;
+        prepared.m_world_position = glm::vec3(light.m_light_pos);
+        prepared.m_view_position = glm::vec3(i_view * glm::vec4(prepared.m_world_position, 1.0f));
+        prepared.m_luminance = (0.299f * color.r + 0.587f * color.g + 0.114f * color.b) * LIGHT_MAX_LUMINANCE;
+        prepared.m_range = point_light_range(light, prepared.m_luminance);
+    }
+    m_selected_count = 0;
+}
+
+void Lighting::select_lights(glm::vec3 i_center, float i_radius) {
+    /* Kept sorted strongest first, a full list drops its weakest */
+    float strengths[LIGHT_MAX_PER_OBJECT];
+    m_selected_count = 0;
+    for (size_t i = 0; i < m_prepared.size(); i++) {
+        const PreparedLight& prepared = m_prepared[i];
+        if (prepared.m_range <= 0.0f) continue;
+        float gap = glm::length(prepared.m_world_position - i_center) - i_radius;
+        if (gap > prepared.m_range) continue;
+
+        float strength = prepared.m_luminance * attenuation(m_point_lights[i], gap > 0.0f ? gap : 0.0f);
+        int slot = m_selected_count;
+        if (slot == LIGHT_MAX_PER_OBJECT) {
+            if (strength <= strengths[slot - 1]) continue;
+            slot--;
+        } else {
+            m_selected_count++;
+        }
+        while (slot > 0 && strengths[slot - 1] < strength) {
+            strengths[slot] = strengths[slot - 1];
+            m_selected[slot] = m_selected[slot - 1];
+            slot--;
+        }
+        strengths[slot] = strength;
+        m_selected[slot] = i;
+    }
+}
+
+int Lighting::get_selected_light_count() const {
+    return m_selected_count;
+}
+
+const PointLight& Lighting::get_selected_light(int i_slot) const {
+    return m_point_lights[m_selected[i_slot]];
+}
+
+float Lighting::shade_directional(glm::vec3 i_normal) const {
+    float wrapped = (glm::dot(i_normal, m_view_to_light) + 1.0f) * 0.5f;
+    return (m_ambient + m_directional.m_intensity * wrapped) * LIGHT_MAX_LUMINANCE;
+}
+
+float Lighting::shade_point_lights(glm::vec3 i_position, glm::vec3 i_normal) const {
+    float luminance = 0.0f;
+    for (int s = 0; s < m_selected_count; s++) {
+        const PointLight& light = m_point_lights[m_selected[s]];
+        const PreparedLight& prepared = m_prepared[m_selected[s]];
+        glm::vec3 to_light = prepared.m_view_position - i_position;
+        float distance = glm::length(to_light);
+        float n_dot_l = distance > 0.0f ? glm::dot(i_normal, to_light) / distance : 1.0f;
+        float diffuse = n_dot_l > 0.0f ? n_dot_l : 0.0f;
+        luminance += (light.m_ambientIntensity + diffuse) * attenuation(light, distance) * prepared.m_luminance;
+    }
+    return luminance;
+}
+
+bool Lighting::has_point_lights() const {
+    return m_selected_count > 0;
+}
@@ -0,0 +1,146 @@
+#include "LineRasterizer.hpp"
+#include <cmath>
+#include <cstdint>
+#include "ScreenGlobals.hpp"
+#include "utils.hpp"
+
+static inline int clamp_int(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/* Pixels from y0 to y1 of one column, clipped to the target */
+static inline void plot_column(RenderTarget& target, int x, int y0, int y1, int z) {
+    /* Thick lines reach past the target, bail before forming any pointer */
+    if (x < 0 || x >= target.m_width) return;
+    y0 = y0 < 0 ? 0 : y0;
+    y1 = y1 >= target.m_height ? target.m_height - 1 : y1;
+    if (y0 > y1) return;
+    uint8_t bit = (uint8_t)(0x80 >> (x & 7));
+    uint8_t* byte = target.m_data + y0 * target.m_rowbytes + (x >> 3);
+    int* depth = target.m_depth_buffer + y0 * target.m_width + x;
+    for (int y = y0; y <= y1; y++, byte += target.m_rowbytes, depth += target.m_width) {
+        if (z < *depth) {
+            *depth = z;
+            *byte &= ~bit;
+        }
+    }
+}
+
+/* Pixels from x0 to x1 of one row, clipped to the target and cleared a
+   byte at a time */
+static inline void plot_row(RenderTarget& target, int y, int x0, int x1, int z) {
+    if (y < 0 || y >= target.m_height) return;
+    x0 = x0 < 0 ? 0 : x0;
+    x1 = x1 >= target.m_width ? target.m_width - 1 : x1;
+    if (x0 > x1) return;
+    uint8_t* row = target.m_data + y * target.m_rowbytes;
+    int* depth = target.m_depth_buffer + y * target.m_width;
+    uint8_t mask = 0;
+    for (int x = x0; x <= x1; x++) {
+        if (z < depth[x]) {
+            depth[x] = z;
+            mask |= 0x80 >> (x & 7);
+        }
+        if ((x & 7) == 7 || x == x1) {
+            row[x >> 3] &= ~mask;
+            mask = 0;
+        }
+    }
+}
+
+void draw_line(RenderTarget& target, glm::vec3 i_a, glm::vec3 i_b,
+    int i_thickness, int i_depth_bias) {
+    /* Grow the clip window by the half width so thick lines along the
+       border keep their outer pixels */
+    int half = (i_thickness - 1) / 2;
+    const int min_x = target.m_origin_x - half;
+    const int max_x = target.m_origin_x + target.m_width - 1 + half;
+    const int min_y = target.m_origin_y - half;
+    const int max_y = target.m_origin_y + target.m_height - 1 + half;
+
+    /* Liang-Barsky */
+    float dx = i_b.x - i_a.x;
+    float dy = i_b.y - i_a.y;
+    float p[4] = { -dx, dx, -dy, dy };
+    float q[4] = { i_a.x - min_x, max_x - i_a.x, i_a.y - min_y, max_y - i_a.y };
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+    for (int k = 0; k < 4; k++) {
+        if (p[k] == 0.0f) {
+            if (q[k] < 0.0f) return;
+            continue;
+        }
+        float r = q[k] / p[k];
+        if (p[k] < 0.0f) {
+            if (r > t1) return;
+            if (r > t0) t0 = r;
+        } else {
+            if (r < t0) return;
+            if (r < t1) t1 = r;
+        }
+    }
+
+    /* Target relative pixels from here on */
+    int x0 = clamp_int((int)floorf(i_a.x + dx * t0 + 0.5f), min_x, max_x) - target.m_origin_x;
+    int y0 = clamp_int((int)floorf(i_a.y + dy * t0 + 0.5f), min_y, max_y) - target.m_origin_y;
+    int x1 = clamp_int((int)floorf(i_a.x + dx * t1 + 0.5f), min_x, max_x) - target.m_origin_x;
+    int y1 = clamp_int((int)floorf(i_a.y + dy * t1 + 0.5f), min_y, max_y) - target.m_origin_y;
+
+    int z_scale = INT16_MAX;
+    int z0 = (int)(my_lerp(i_a.z, i_b.z, t0) * z_scale) - i_depth_bias;
+    int z1 = (int)(my_lerp(i_a.z, i_b.z, t1) * z_scale) - i_depth_bias;
+
+    int adx = x1 > x0 ? x1 - x0 : x0 - x1;
+    int ady = y1 > y0 ? y1 - y0 : y0 - y1;
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = adx - ady;
+    int steps = adx > ady ? adx : ady;
+    bool shallow = adx >= ady;
+
+    int64_t dz = steps > 0 ? ((int64_t)(z1 - z0) << 16) / steps : 0;
+    int64_t z = (int64_t)z0 << 16;
+    int x = x0;
+    int y = y0;
+    for (int i = 0; i <= steps; i++, z += dz) {
+        int zi = (int)(z >> 16);
+        if (i_thickness <= 1) {
+            if (x >= 0 && x < target.m_width && y >= 0 && y < target.m_height) {
+                int idx = y * target.m_width + x;
+                if (zi < target.m_depth_buffer[idx]) {
+                    target.m_depth_buffer[idx] = zi;
+                    setpixel(target.m_data, x, y, target.m_rowbytes);
+                }
+            }
+        } else if (shallow) {
+            plot_column(target, x, y - half, y - half + i_thickness - 1, zi);
+        } else {
+            plot_row(target, y, x - half, x - half + i_thickness - 1, zi);
+        }
+        int e2 = 2 * err;
+        if (e2 > -ady) { err -= ady; x += sx; }
+        if (e2 < adx) { err += adx; y += sy; }
+    }
+}
+
+void draw_view_line(RenderTarget& target, const glm::mat4& i_projection,
+    glm::vec4 i_a, glm::vec4 i_b, int i_thickness, int i_depth_bias) {
+    const float near_z = -NEAR_PLANE;
+    if (i_a.z > near_z && i_b.z > near_z) return;
+    if (i_a.z > near_z) {
+        i_a = i_b + (i_a - i_b) * ((near_z - i_b.z) / (i_a.z - i_b.z));
+    } else if (i_b.z > near_z) {
+        i_b = i_a + (i_b - i_a) * ((near_z - i_a.z) / (i_b.z - i_a.z));
+    }
+
+    glm::vec4 clip_a = i_projection * glm::vec4(glm::vec3(i_a), 1.0f);
+    glm::vec4 clip_b = i_projection * glm::vec4(glm::vec3(i_b), 1.0f);
+    float inv_wa = 1.0f / clip_a.w;
+    float inv_wb = 1.0f / clip_b.w;
+    const float hw = SCREEN_WIDTH * 0.5f;
+    const float hh = SCREEN_HEIGHT * 0.5f;
+    draw_line(target,
+        { (clip_a.x * inv_wa + 1.0f) * hw, (1.0f - clip_a.y * inv_wa) * hh, clip_a.z * inv_wa * 0.5f + 0.5f },
+        { (clip_b.x * inv_wb + 1.0f) * hw, (1.0f - clip_b.y * inv_wb) * hh, clip_b.z * inv_wb * 0.5f + 0.5f },
+        i_thickness, i_depth_bias);
+}
@@ -0,0 +1,84 @@
+#include "Matcap.hpp"
+#include <cctype>
+
+Matcap::Matcap() {}
+Matcap::~Matcap() {}
+
+/* Next whitespace separated header number, skipping # comments */
+static bool read_header_number(const std::vector<uint8_t>& i_data, size_t& io_offset, int& o_value) {
+    while (io_offset < i_data.size()) {
+        if (i_data[io_offset] == '#') {
+            while (io_offset < i_data.size() && i_data[io_offset] != '\n') io_offset++;
+        } else if (isspace(i_data[io_offset])) {
+            io_offset++;
+        } else {
+            break;
+        }
+    }
+    if (io_offset >= i_data.size() || !isdigit(i_data[io_offset])) return false;
+    o_value = 0;
+    while (io_offset < i_data.size() && isdigit(i_data[io_offset])) {
+        o_value = o_value * 10 + (i_data[io_offset] - '0');
+        if (o_value > 65535) return false;
+        io_offset++;
+    }
+    return true;
+}
+
+bool Matcap::load(PlaydateAPI* pd, const char* i_filepath) {
+    FileStat stat;
+    if (pd->file->stat(i_filepath, &stat) != 0) {
+        pd->system->logToConsole("Couldn't find matcap %s: %s", i_filepath, pd->file->geterr());
+        return false;
+    }
+    SDFile* file = pd->file->open(i_filepath, kFileRead);
+    if (file == nullptr) {
+        pd->system->logToConsole("Couldn't open matcap %s: %s", i_filepath, pd->file->geterr());
+        return false;
+    }
+    std::vector<uint8_t> data(stat.size);
+    int read = pd->file->read(file, data.data(), stat.size);
+    pd->file->close(file);
+    if (read != (int)stat.size) {
+        pd->system->logToConsole("Couldn't read matcap %s", i_filepath);
+        return false;
+    }
+
+    size_t offset = 2;
+    int width, height, max_value;
+    if (data.size() < 2 || data[0] != 'P' || data[1] != '5'
+        || !read_header_number(data, offset, width)
+        || !read_header_number(data, offset, height)
+        || !read_header_number(data, offset, max_value)) {
+        pd->system->logToConsole("Matcap %s isn't a binary PGM", i_filepath);
+        return false;
+    }
+    /* A single whitespace byte separates the header from the pixels */
+    offset++;
+    if (width != height || width == 0 || width > MATCAP_MAX_SIZE
+        || max_value == 0 || max_value > 255
+        || offset + (size_t)width * height > data.size()) {
+        pd->system->logToConsole("Matcap %s must be square, 8-bit and at most %d pixels wide",
+            i_filepath, MATCAP_MAX_SIZE);
+        return false;
+    }
+
+    m_size = width;
+    m_luminance.resize(width * height);
+    for (int i = 0; i < width * height; i++) {
+        m_luminance[i] = (uint8_t)(data[offset + i] * 255 / max_value);
+    }
+    return true;
+}
+
+bool Matcap::is_loaded() const {
+    return m_size > 0;
+}
+
+float Matcap::shade(glm::vec3 i_normal) const {
+    int x = (int)((i_normal.x * 0.5f + 0.5f) * m_size);
+    int y = (int)((0.5f - i_normal.y * 0.5f) * m_size);
+    x = x < 0 ? 0 : (x >= m_size ? m_size - 1 : x);
+    y = y < 0 ? 0 : (y >= m_size ? m_size - 1 : y);
+    return m_luminance[y * m_size + x];
+}
@@ -0,0 +1,55 @@
+#include "Material.hpp"
+#include <cmath>
+
+static float luminance(glm::vec3 i_color) {
+    return 0.299f * i_color.r + 0.587f * i_color.g + 0.114f * i_color.b;
+}
+
+Material::Material() {
+    for (int i = 0; i < 256; i++) {
+        m_luminance_lut[i] = i;
+    }
+}
+
+void Material::compile_luminance_lut() {
+    float ambient = luminance(m_ambient) * MATERIAL_AMBIENT_LIGHT;
+    float diffuse = luminance(m_diffuse);
+    float specular = luminance(m_specular);
+
+    for (int i = 0; i < 256; i++) {
+        /* The unlit luminance is the wrapped N.L term, it doubles as a
+           stand-in for N.H in the highlight */
+        float n_dot_l = i / 255.0f;
+        float lit = ambient + diffuse * n_dot_l;
+        if (specular > 0.0f && m_shininess > 0.0f) {
+            lit += specular * powf(n_dot_l, m_shininess);
+        }
+        m_luminance_lut[i] = (uint8_t)lroundf(fminf(fmaxf(lit, 0.0f), 1.0f) * 255.0f);
+    }
+}
+
+std::shared_ptr<Material> Material::get_default() {
+    static std::shared_ptr<Material> default_material = std::make_shared<Material>();
+    return default_material;
+}
+
+std::vector<MaterialRange> create_material_ranges(
+    const MeshMaterialRange* i_ranges, int i_range_count, int i_triangle_count) {
+    std::vector<MaterialRange> ranges;
+    for (int i = 0; i < i_range_count; i++) {
+        const MeshMaterialRange& range = i_ranges[i];
+        if (range.m_triangle_count == 0
+            || range.m_first_triangle + range.m_triangle_count > (uint32_t)i_triangle_count) {
+            continue;
+        }
+        std::shared_ptr<Material> material = std::make_shared<Material>();
+        material->m_ambient = glm::vec3(range.m_ambient[0], range.m_ambient[1], range.m_ambient[2]);
+        material->m_diffuse = glm::vec3(range.m_diffuse[0], range.m_diffuse[1], range.m_diffuse[2]);
+        material->m_specular = glm::vec3(range.m_specular[0], range.m_specular[1], range.m_specular[2]);
+        material->m_shininess = range.m_shininess;
+        material->m_dither_kernel = dither_kernel_from_index(range.m_dither_kernel);
+        material->compile_luminance_lut();
+        ranges.push_back({(int)range.m_first_triangle * 3, (int)range.m_triangle_count * 3, material});
+    }
+    return ranges;
+}
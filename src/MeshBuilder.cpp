@@ -0,0 +1,132 @@
+#include "MeshBuilder.hpp"
+
+MeshBuilder::MeshBuilder() {}
+MeshBuilder::~MeshBuilder() {}
+
+void MeshBuilder::clear() {
+    m_vertex_buffer.clear();
+    m_normal_buffer.clear();
+    m_index_buffer.clear();
+    m_normal_index_buffer.clear();
+    m_flat_normals.clear();
+    m_material_ranges.clear();
+}
+
+void MeshBuilder::reserve(int i_position_count, int i_normal_count, int i_triangle_count) {
+    m_vertex_buffer.reserve(i_position_count * 3);
+    m_normal_buffer.reserve(i_normal_count * 3);
+    m_index_buffer.reserve(i_triangle_count * 3);
+    m_normal_index_buffer.reserve(i_triangle_count * 3);
+}
+
+void MeshBuilder::add_position(glm::vec3 i_position) {
+    m_vertex_buffer.push_back(i_position.x);
+    m_vertex_buffer.push_back(i_position.y);
+    m_vertex_buffer.push_back(i_position.z);
+}
+
+void MeshBuilder::add_normal(glm::vec3 i_normal) {
+    m_normal_buffer.push_back(i_normal.x);
+    m_normal_buffer.push_back(i_normal.y);
+    m_normal_buffer.push_back(i_normal.z);
+}
+
+bool MeshBuilder::add_polygon(const std::array<int, 3>* i_corners, int i_corner_count) {
+    if (i_corner_count < 3) return false;
+    int vertex_count = position_count();
+    for (int i = 0; i < i_corner_count; i++) {
+        if (i_corners[i][0] >= vertex_count) return false;
+    }
+
+    int existing_normals = normal_count();
+    int flat_normal = 0;
+    for (int i = 0; i < i_corner_count; i++) {
+        if (i_corners[i][2] < 0 || i_corners[i][2] >= existing_normals) {
+            flat_normal = add_flat_normal(i_corners, i_corner_count);
+            break;
+        }
+    }
+
+    /* Fan around the first corner, fine for the convex polygons exporters write */
+    for (int i = 1; i + 1 < i_corner_count; i++) {
+        const std::array<int, 3>* triangle[3] = {&i_corners[0], &i_corners[i], &i_corners[i + 1]};
+        for (const std::array<int, 3>* corner : triangle) {
+            int normal = (*corner)[2];
+            if (normal < 0 || normal >= existing_normals) {
+                normal = flat_normal;
+            }
+            m_index_buffer.push_back((*corner)[0]);
+            m_normal_index_buffer.push_back(normal);
+        }
+    }
+    return true;
+}
+
+void MeshBuilder::set_material(std::shared_ptr<Material> i_material) {
+    int first_index = m_index_buffer.size();
+    if (!m_material_ranges.empty() && m_material_ranges.back().m_first_index == first_index) {
+        m_material_ranges.back().m_material = i_material;
+        return;
+    }
+    m_material_ranges.push_back({first_index, 0, i_material});
+}
+
+int MeshBuilder::add_flat_normal(const std::array<int, 3>* i_corners, int i_corner_count) {
+    /* Newell's method, robust for polygons with collinear leading corners */
+    glm::vec3 normal{0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < i_corner_count; i++) {
+        const float* a = &m_vertex_buffer[i_corners[i][0] * 3];
+        const float* b = &m_vertex_buffer[i_corners[(i + 1) % i_corner_count][0] * 3];
+        normal.x += (a[1] - b[1]) * (a[2] + b[2]);
+        normal.y += (a[2] - b[2]) * (a[0] + b[0]);
+        normal.z += (a[0] - b[0]) * (a[1] + b[1]);
+    }
+    float length = glm::length(normal);
+    if (length > 0.0f) normal /= length;
+    m_flat_normals.push_back(normal);
+    return -(int)m_flat_normals.size();
+}
+
+int MeshBuilder::position_count() {
+    return m_vertex_buffer.size() / 3;
+}
+
+int MeshBuilder::normal_count() {
+    return m_normal_buffer.size() / 3;
+}
+
+int MeshBuilder::triangle_count() {
+    return m_index_buffer.size() / 3;
+}
+
+std::shared_ptr<IndexedVertexData> MeshBuilder::build(int i_stride) {
+    /* Generated normals go after the ones from the file */
+    int file_normals = normal_count();
+    for (int& normal : m_normal_index_buffer) {
+        if (normal < 0) normal = file_normals - normal - 1;
+    }
+    for (glm::vec3& normal : m_flat_normals) {
+        add_normal(normal);
+    }
+
+    /* Faces before the first usemtl keep the default material */
+    std::vector<MaterialRange> ranges;
+    int end_index = m_index_buffer.size();
+    if (m_material_ranges.empty() || m_material_ranges[0].m_first_index > 0) {
+        m_material_ranges.insert(m_material_ranges.begin(), {0, 0, Material::get_default()});
+    }
+    for (size_t i = 0; i < m_material_ranges.size(); i++) {
+        MaterialRange range = m_material_ranges[i];
+        int next_index = i + 1 < m_material_ranges.size() ? m_material_ranges[i + 1].m_first_index : end_index;
+        range.m_index_count = next_index - range.m_first_index;
+        if (range.m_index_count > 0) ranges.push_back(range);
+    }
+    std::shared_ptr<IndexedVertexData> vertex_data = std::make_shared<IndexedVertexData>(
+        std::move(m_vertex_buffer), std::move(m_index_buffer),
+        std::move(m_normal_buffer), std::move(m_normal_index_buffer), i_stride);
+    if (!ranges.empty()) {
+        vertex_data->set_material_ranges(std::move(ranges));
+    }
+    clear();
+    return vertex_data;
+}
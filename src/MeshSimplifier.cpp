@@ -0,0 +1,356 @@
+#include "MeshSimplifier.hpp"
+#include <queue>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cmath>
+
+/* Weight of the virtual planes that pin open mesh borders in place */
+static const float BOUNDARY_WEIGHT = 100.0f;
+/* Twice the area below which a triangle is treated as a line, in
+   normalized units where the mesh spans about 1 */
+static const float DEGENERATE_AREA = 1e-9f;
+/* A solve for the collapse target is trusted while the system's
+   determinant stays above this fraction of its largest possible value */
+static const float SINGULAR_DETERMINANT = 1e-6f;
+
+static inline std::array<float, 10> plane_quadric(float a, float b, float c, float d, float w) {
+    return {
+        w * a * a, w * a * b, w * a * c, w * a * d,
+        w * b * b, w * b * c, w * b * d,
+        w * c * c, w * c * d,
+        w * d * d
+    };
+}
+
+static inline void add_quadric(std::array<float, 10>& io_a, const std::array<float, 10>& i_b) {
+    for (int i = 0; i < 10; i++) {
+        io_a[i] += i_b[i];
+    }
+}
+
+static inline float quadric_error(const std::array<float, 10>& q, glm::vec3 v) {
+    return q[0] * v.x * v.x + 2 * q[1] * v.x * v.y + 2 * q[2] * v.x * v.z + 2 * q[3] * v.x
+         + q[4] * v.y * v.y + 2 * q[5] * v.y * v.z + 2 * q[6] * v.y
+         + q[7] * v.z * v.z + 2 * q[8] * v.z
+         + q[9];
+}
+
+MeshSimplifier::MeshSimplifier(
+    std::span<const float> i_vertex_buffer,
+    std::span<const int> i_index_buffer,
+    std::span<const int> i_normal_index_buffer) {
+    int vertex_count = i_vertex_buffer.size() / 3;
+    glm::vec3 min_corner{0.0f};
+    glm::vec3 max_corner{0.0f};
+    for (int i = 0; i < vertex_count; i++) {
+        glm::vec3 p{i_vertex_buffer[i * 3], i_vertex_buffer[i * 3 + 1], i_vertex_buffer[i * 3 + 2]};
+        min_corner = i == 0 ? p : glm::min(min_corner, p);
+        max_corner = i == 0 ? p : glm::max(max_corner, p);
+    }
+    m_center = (min_corner + max_corner) * 0.5f;
+    float extent = glm::length(max_corner - min_corner);
+    m_scale = extent > 0.0f ? extent : 1.0f;
+
+    m_positions.reserve(vertex_count);
+    for (int i = 0; i < vertex_count; i++) {
+        glm::vec3 p{i_vertex_buffer[i * 3], i_vertex_buffer[i * 3 + 1], i_vertex_buffer[i * 3 + 2]};
+        m_positions.push_back((p - m_center) / m_scale);
+    }
+
+    m_vertex_triangles.resize(vertex_count);
+    m_vertex_stamps.assign(vertex_count, 0);
+    m_vertex_removed.assign(vertex_count, false);
+
+    int triangle_count = i_index_buffer.size() / 3;
+    m_triangles.reserve(triangle_count);
+    for (int t = 0; t < triangle_count; t++) {
+        Triangle tri;
+        tri.m_source_index = t;
+        for (int k = 0; k < 3; k++) {
+            tri.m_vertices[k] = i_index_buffer[t * 3 + k];
+            tri.m_normals[k] = i_normal_index_buffer[t * 3 + k];
+        }
+        if (tri.m_vertices[0] == tri.m_vertices[1] ||
+            tri.m_vertices[1] == tri.m_vertices[2] ||
+            tri.m_vertices[0] == tri.m_vertices[2]) {
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            m_vertex_triangles[tri.m_vertices[k]].push_back(m_triangles.size());
+        }
+        m_triangles.push_back(tri);
+    }
+    m_live_triangle_count = m_triangles.size();
+}
+
+MeshSimplifier::~MeshSimplifier() {}
+
+void MeshSimplifier::compute_quadrics() {
+    m_quadrics.assign(m_positions.size(), Quadric{});
+    for (Triangle& tri : m_triangles) {
+        glm::vec3 p0 = m_positions[tri.m_vertices[0]];
+        glm::vec3 p1 = m_positions[tri.m_vertices[1]];
+        glm::vec3 p2 = m_positions[tri.m_vertices[2]];
+        glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+        float len = glm::length(n);
+        if (len < DEGENERATE_AREA) continue;
+        n /= len;
+        /* Area weighted so large faces dominate over slivers */
+        Quadric q = plane_quadric(n.x, n.y, n.z, -glm::dot(n, p0), len * 0.5f);
+        for (int k = 0; k < 3; k++) {
+            add_quadric(m_quadrics[tri.m_vertices[k]], q);
+        }
+    }
+}
+
+void MeshSimplifier::add_boundary_quadrics() {
+    /* An edge used by a single triangle lies on an open border */
+    std::vector<uint64_t> edges;
+    edges.reserve(m_triangles.size() * 3);
+    for (Triangle& tri : m_triangles) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = tri.m_vertices[k];
+            uint32_t b = tri.m_vertices[(k + 1) % 3];
+            edges.push_back(((uint64_t)std::min(a, b) << 32) | std::max(a, b));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+
+    for (Triangle& tri : m_triangles) {
+        glm::vec3 p0 = m_positions[tri.m_vertices[0]];
+        glm::vec3 p1 = m_positions[tri.m_vertices[1]];
+        glm::vec3 p2 = m_positions[tri.m_vertices[2]];
+        glm::vec3 face_n = glm::cross(p1 - p0, p2 - p0);
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = tri.m_vertices[k];
+            uint32_t b = tri.m_vertices[(k + 1) % 3];
+            uint64_t key = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+            auto range = std::equal_range(edges.begin(), edges.end(), key);
+            if (range.second - range.first != 1) continue;
+
+            glm::vec3 pa = m_positions[a];
+            glm::vec3 edge = m_positions[b] - pa;
+            glm::vec3 n = glm::cross(edge, face_n);
+            float len = glm::length(n);
+            if (len < DEGENERATE_AREA) continue;
+            n /= len;
+            Quadric q = plane_quadric(
+                n.x, n.y, n.z, -glm::dot(n, pa), BOUNDARY_WEIGHT * glm::dot(edge, edge));
+            add_quadric(m_quadrics[a], q);
+            add_quadric(m_quadrics[b], q);
+        }
+    }
+}
+
+MeshSimplifier::Collapse MeshSimplifier::evaluate_collapse(int i_v1, int i_v2) {
+    Quadric q = m_quadrics[i_v1];
+    add_quadric(q, m_quadrics[i_v2]);
+
+    Collapse result;
+    result.m_v1 = i_v1;
+    result.m_v2 = i_v2;
+    result.m_stamp1 = m_vertex_stamps[i_v1];
+    result.m_stamp2 = m_vertex_stamps[i_v2];
+
+    /* Solve for the position minimising the combined error */
+    glm::mat3 a{
+        q[0], q[1], q[2],
+        q[1], q[4], q[5],
+        q[2], q[5], q[7]
+    };
+    /* The matrix is positive semi-definite, so its determinant is at most
+       the cube of a third of its trace */
+    float det = glm::determinant(a);
+    float trace = (q[0] + q[4] + q[7]) * (1.0f / 3.0f);
+    if (fabsf(det) > SINGULAR_DETERMINANT * trace * trace * trace) {
+        result.m_target = glm::inverse(a) * glm::vec3(-q[3], -q[6], -q[8]);
+        result.m_cost = quadric_error(q, result.m_target);
+        return result;
+    }
+
+    /* Singular system, fall back to the endpoints and the midpoint */
+    glm::vec3 candidates[3] = {
+        m_positions[i_v1],
+        m_positions[i_v2],
+        (m_positions[i_v1] + m_positions[i_v2]) * 0.5f
+    };
+    result.m_target = candidates[0];
+    result.m_cost = quadric_error(q, candidates[0]);
+    for (int i = 1; i < 3; i++) {
+        float cost = quadric_error(q, candidates[i]);
+        if (cost < result.m_cost) {
+            result.m_cost = cost;
+            result.m_target = candidates[i];
+        }
+    }
+    return result;
+}
+
+bool MeshSimplifier::collapse_flips_faces(int i_v, int i_other, glm::vec3 i_target) {
+    for (int t : m_vertex_triangles[i_v]) {
+        Triangle& tri = m_triangles[t];
+        if (tri.m_removed) continue;
+        if (tri.m_vertices[0] == i_other || tri.m_vertices[1] == i_other || tri.m_vertices[2] == i_other) {
+            continue;
+        }
+        glm::vec3 before[3];
+        glm::vec3 after[3];
+        for (int k = 0; k < 3; k++) {
+            before[k] = m_positions[tri.m_vertices[k]];
+            after[k] = tri.m_vertices[k] == i_v ? i_target : before[k];
+        }
+        glm::vec3 n_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+        glm::vec3 n_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+        if (glm::dot(n_before, n_after) <= 0.0f) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int MeshSimplifier::apply_collapse(Collapse& i_collapse) {
+    int v1 = i_collapse.m_v1;
+    int v2 = i_collapse.m_v2;
+    int removed = 0;
+
+    m_positions[v1] = i_collapse.m_target;
+    add_quadric(m_quadrics[v1], m_quadrics[v2]);
+
+    for (int t : m_vertex_triangles[v2]) {
+        Triangle& tri = m_triangles[t];
+        if (tri.m_removed) continue;
+        bool has_v1 = false;
+        for (int k = 0; k < 3; k++) {
+            if (tri.m_vertices[k] == v1) has_v1 = true;
+        }
+        if (has_v1) {
+            tri.m_removed = true;
+            removed++;
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            if (tri.m_vertices[k] == v2) tri.m_vertices[k] = v1;
+        }
+        m_vertex_triangles[v1].push_back(t);
+    }
+    m_vertex_triangles[v2].clear();
+    m_vertex_removed[v2] = true;
+    m_vertex_stamps[v1]++;
+
+    /* Drop the dead entries so later walks over v1 stay short */
+    std::vector<int>& tris = m_vertex_triangles[v1];
+    tris.erase(std::remove_if(tris.begin(), tris.end(),
+        [this](int t) { return m_triangles[t].m_removed; }), tris.end());
+
+    m_live_triangle_count -= removed;
+    return removed;
+}
+
+void MeshSimplifier::gather_neighbours(int i_v, std::vector<int>& o_neighbours) {
+    o_neighbours.clear();
+    for (int t : m_vertex_triangles[i_v]) {
+        Triangle& tri = m_triangles[t];
+        if (tri.m_removed) continue;
+        for (int k = 0; k < 3; k++) {
+            int n = tri.m_vertices[k];
+            if (n != i_v) o_neighbours.push_back(n);
+        }
+    }
+    std::sort(o_neighbours.begin(), o_neighbours.end());
+    o_neighbours.erase(std::unique(o_neighbours.begin(), o_neighbours.end()), o_neighbours.end());
+}
+
+void MeshSimplifier::simplify(int i_target_triangle_count) {
+    compute_quadrics();
+    add_boundary_quadrics();
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+    std::vector<int> neighbours;
+    for (int v = 0; v < (int)m_positions.size(); v++) {
+        gather_neighbours(v, neighbours);
+        for (int n : neighbours) {
+            if (n > v) heap.push(evaluate_collapse(v, n));
+        }
+    }
+
+    while (m_live_triangle_count > i_target_triangle_count && !heap.empty()) {
+        Collapse collapse = heap.top();
+        heap.pop();
+
+        int v1 = collapse.m_v1;
+        int v2 = collapse.m_v2;
+        if (m_vertex_removed[v1] || m_vertex_removed[v2]) continue;
+        if (collapse.m_stamp1 != m_vertex_stamps[v1] || collapse.m_stamp2 != m_vertex_stamps[v2]) {
+            continue;
+        }
+        if (collapse_flips_faces(v1, v2, collapse.m_target) ||
+            collapse_flips_faces(v2, v1, collapse.m_target)) {
+            continue;
+        }
+
+        apply_collapse(collapse);
+
+        gather_neighbours(v1, neighbours);
+        for (int n : neighbours) {
+            heap.push(evaluate_collapse(v1, n));
+        }
+    }
+}
+
+std::vector<float> MeshSimplifier::get_vertex_buffer() {
+    std::vector<float> result;
+    std::vector<bool> used(m_positions.size(), false);
+    for (Triangle& tri : m_triangles) {
+        if (tri.m_removed) continue;
+        for (int k = 0; k < 3; k++) used[tri.m_vertices[k]] = true;
+    }
+    for (int v = 0; v < (int)m_positions.size(); v++) {
+        if (!used[v]) continue;
+        glm::vec3 p = m_center + m_positions[v] * m_scale;
+        result.push_back(p.x);
+        result.push_back(p.y);
+        result.push_back(p.z);
+    }
+    return result;
+}
+
+std::vector<int> MeshSimplifier::get_index_buffer() {
+    /* Remap to the compacted order produced by get_vertex_buffer */
+    std::vector<int> remap(m_positions.size(), -1);
+    for (Triangle& tri : m_triangles) {
+        if (tri.m_removed) continue;
+        for (int k = 0; k < 3; k++) remap[tri.m_vertices[k]] = 0;
+    }
+    int next = 0;
+    for (int v = 0; v < (int)remap.size(); v++) {
+        if (remap[v] == 0) remap[v] = next++;
+    }
+
+    std::vector<int> result;
+    result.reserve(m_live_triangle_count * 3);
+    for (Triangle& tri : m_triangles) {
+        if (tri.m_removed) continue;
+        for (int k = 0; k < 3; k++) result.push_back(remap[tri.m_vertices[k]]);
+    }
+    return result;
+}
+
+std::vector<int> MeshSimplifier::get_normal_index_buffer() {
+    std::vector<int> result;
+    result.reserve(m_live_triangle_count * 3);
+    for (Triangle& tri : m_triangles) {
+        if (tri.m_removed) continue;
+        for (int k = 0; k < 3; k++) result.push_back(tri.m_normals[k]);
+    }
+    return result;
+}
+
+std::vector<int> MeshSimplifier::get_source_triangles() {
+    std::vector<int> result;
+    result.reserve(m_live_triangle_count);
+    for (Triangle& tri : m_triangles) {
+        if (!tri.m_removed) result.push_back(tri.m_source_index);
+    }
+    return result;
+}
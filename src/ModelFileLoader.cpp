@@ -0,0 +1,21 @@
+#include "ModelFileLoader.hpp"
+
+SceneObject ModelFileLoader::create_scene_object_from_file(
+    std::string i_filepath, PlaydateAPI* pd
+) {
+    unsigned int start_ms = pd->system->getCurrentTimeMilliseconds();
+    if (!begin_load(i_filepath, pd)) {
+        return SceneObject{};
+    }
+    while (!continue_load(pd)) {}
+    std::shared_ptr<IndexedVertexData> vertex_data = finish_load(pd);
+    if (vertex_data == nullptr) {
+        return SceneObject{};
+    }
+
+    SceneObject scene_object{vertex_data};
+    scene_object.generate_lods(m_lod_count);
+    pd->system->logToConsole("Loaded %s in %u ms", i_filepath.c_str(),
+        pd->system->getCurrentTimeMilliseconds() - start_ms);
+    return scene_object;
+}
@@ -0,0 +1,69 @@
+#include "NormalPalette.hpp"
+#include <cmath>
+#include "utils.hpp"
+
+static inline float sign_not_zero(float v) {
+    return v < 0.0f ? -1.0f : 1.0f;
+}
+
+uint16_t encode_palette_normal(glm::vec3 i_normal) {
+    /* Project onto the octahedron |x| + |y| + |z| = 1, the lower half
+       folds out over the corners of the upper one */
+    float sum = my_abs(i_normal.x) + my_abs(i_normal.y) + my_abs(i_normal.z);
+    if (sum <= 0.0f) return 0;
+    float x = i_normal.x / sum;
+    float y = i_normal.y / sum;
+    if (i_normal.z < 0.0f) {
+        float folded_x = (1.0f - my_abs(y)) * sign_not_zero(x);
+        y = (1.0f - my_abs(x)) * sign_not_zero(y);
+        x = folded_x;
+    }
+    const float cells = (float)(NORMAL_PALETTE_RESOLUTION - 1);
+    int u = (int)((x * 0.5f + 0.5f) * cells + 0.5f);
+    int v = (int)((y * 0.5f + 0.5f) * cells + 0.5f);
+    u = u < 0 ? 0 : (u > NORMAL_PALETTE_RESOLUTION - 1 ? NORMAL_PALETTE_RESOLUTION - 1 : u);
+    v = v < 0 ? 0 : (v > NORMAL_PALETTE_RESOLUTION - 1 ? NORMAL_PALETTE_RESOLUTION - 1 : v);
+    return (uint16_t)(v * NORMAL_PALETTE_RESOLUTION + u);
+}
+
+static std::array<glm::vec3, NORMAL_PALETTE_SIZE> decode_normal_palette() {
+    std::array<glm::vec3, NORMAL_PALETTE_SIZE> palette;
+    const float cells = (float)(NORMAL_PALETTE_RESOLUTION - 1);
+    for (int v = 0; v < NORMAL_PALETTE_RESOLUTION; v++) {
+        for (int u = 0; u < NORMAL_PALETTE_RESOLUTION; u++) {
+            float x = u / cells * 2.0f - 1.0f;
+            float y = v / cells * 2.0f - 1.0f;
+            float z = 1.0f - my_abs(x) - my_abs(y);
+            if (z < 0.0f) {
+                float folded_x = (1.0f - my_abs(y)) * sign_not_zero(x);
+                y = (1.0f - my_abs(x)) * sign_not_zero(y);
+                x = folded_x;
+            }
+            palette[v * NORMAL_PALETTE_RESOLUTION + u] = glm::normalize(glm::vec3(x, y, z));
+        }
+    }
+    return palette;
+}
+
+const std::array<glm::vec3, NORMAL_PALETTE_SIZE>& get_normal_palette() {
+    static const std::array<glm::vec3, NORMAL_PALETTE_SIZE> palette = decode_normal_palette();
+    return palette;
+}
+
+NormalPaletteCache::NormalPaletteCache() {}
+NormalPaletteCache::~NormalPaletteCache() {}
+
+void NormalPaletteCache::begin(const glm::mat3& i_normal_mat, const Lighting& i_lighting,
+    const Matcap* i_matcap) {
+    m_normal_mat = i_normal_mat;
+    m_lighting = &i_lighting;
+    m_matcap = i_matcap;
+    m_stamp++;
+}
+
+void NormalPaletteCache::update(uint16_t i_index) {
+    m_stamps[i_index] = m_stamp;
+    glm::vec3 normal = glm::normalize(m_normal_mat * get_normal_palette()[i_index]);
+    m_view_normals[i_index] = normal;
+    m_intensities[i_index] = m_matcap != nullptr ? m_matcap->shade(normal) : m_lighting->shade_directional(normal);
+}
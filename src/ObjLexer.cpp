@@ -0,0 +1,177 @@
+#include "ObjLexer.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+static bool is_whitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+ObjLexer::ObjLexer(std::string_view i_line) {
+    m_cursor = i_line.data();
+    m_end = i_line.data() + i_line.size();
+}
+
+void ObjLexer::skip_whitespace() {
+    while (m_cursor < m_end && is_whitespace(*m_cursor)) {
+        m_cursor++;
+    }
+    if (m_cursor < m_end && *m_cursor == '#') {
+        m_cursor = m_end;
+    }
+}
+
+bool ObjLexer::at_end() {
+    skip_whitespace();
+    return m_cursor == m_end;
+}
+
+std::string_view ObjLexer::next_token() {
+    skip_whitespace();
+    const char* start = m_cursor;
+    while (m_cursor < m_end && !is_whitespace(*m_cursor)) {
+        m_cursor++;
+    }
+    return std::string_view(start, m_cursor - start);
+}
+
+bool ObjLexer::next_float(float& o_value) {
+    return parse_float(next_token(), o_value);
+}
+
+bool ObjLexer::next_int(int& o_value) {
+    return parse_int(next_token(), o_value);
+}
+
+// Past this decimal exponent any float mantissa is 0 or infinite
+static const int FLOAT_EXPONENT_LIMIT = 400;
+
+// Powers of ten that are exact in a double
+static const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool parse_float(std::string_view i_text, float& o_value) {
+    const char* p = i_text.data();
+    const char* end = p + i_text.size();
+    if (p == end) return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = *p == '-';
+        p++;
+    }
+
+    /* Up to 19 significant digits fit the mantissa, the rest only shift
+       the exponent, which is plenty for float precision */
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int64_t exponent = 0;
+    bool any_digits = false;
+    for (; p < end && is_digit(*p); p++) {
+        any_digits = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0) digits++;
+        } else {
+            exponent++;
+        }
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && is_digit(*p); p++) {
+            any_digits = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any_digits) return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        int exponent_value;
+        if (!parse_int(std::string_view(p, end - p), exponent_value)) return false;
+        exponent += exponent_value;
+        p = end;
+    }
+    if (p != end) return false;
+
+    /* Clamped, so scaling stays a few steps however far out the exponent */
+    int scale = (int)std::clamp<int64_t>(exponent, -FLOAT_EXPONENT_LIMIT, FLOAT_EXPONENT_LIMIT);
+    double value = (double)mantissa;
+    while (scale > 22) {
+        value *= 1e22;
+        scale -= 22;
+    }
+    while (scale < -22) {
+        value /= 1e22;
+        scale += 22;
+    }
+    value = scale >= 0 ? value * POWERS_OF_TEN[scale] : value / POWERS_OF_TEN[-scale];
+    o_value = (float)(negative ? -value : value);
+    return true;
+}
+
+bool parse_int(std::string_view i_text, int& o_value) {
+    const char* p = i_text.data();
+    const char* end = p + i_text.size();
+    if (p == end) return false;
+
+    bool negative = false;
+    if (*p == '-' || *p == '+') {
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end) return false;
+
+    int value = 0;
+    for (; p < end; p++) {
+        if (!is_digit(*p)) return false;
+        int digit = *p - '0';
+        if (value > (INT_MAX - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+    o_value = negative ? -value : value;
+    return true;
+}
+
+static bool resolve_index(std::string_view i_text, int i_count, int& o_index) {
+    int index;
+    if (!parse_int(i_text, index) || index == 0) return false;
+    o_index = index > 0 ? index - 1 : i_count + index;
+    return o_index >= 0;
+}
+
+bool parse_face_vertex(
+    std::string_view i_token,
+    int i_vertex_count,
+    int i_texture_count,
+    int i_normal_count,
+    std::array<int, 3>& o_indices
+) {
+    o_indices = {-1, -1, -1};
+    const int counts[3] = {i_vertex_count, i_texture_count, i_normal_count};
+
+    for (int slot = 0; slot < 3; slot++) {
+        size_t slash = i_token.find('/');
+        std::string_view part = i_token.substr(0, slash);
+        /* v//vn leaves the texture slot empty, only the vertex is required */
+        if (!part.empty()) {
+            if (!resolve_index(part, counts[slot], o_indices[slot])) return false;
+        } else if (slot == 0) {
+            return false;
+        }
+        if (slash == std::string_view::npos) return true;
+        i_token.remove_prefix(slash + 1);
+    }
+    /* More than two slashes */
+    return false;
+}
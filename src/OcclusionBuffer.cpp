@@ -0,0 +1,148 @@
+#include "OcclusionBuffer.hpp"
+#include <algorithm>
+#include "ScreenGlobals.hpp"
+#include "utils.hpp"
+
+OcclusionBuffer::OcclusionBuffer() {
+    m_depth.resize(OCCLUSION_WIDTH * OCCLUSION_HEIGHT, INFINITY);
+    float tan_half_fov = tanf(glm::radians(FIELD_OF_VIEW_DEGREES) * 0.5f);
+    float aspect = (float)SCREEN_WIDTH / (float)SCREEN_HEIGHT;
+    m_focal_x = (OCCLUSION_WIDTH * 0.5f) / (tan_half_fov * aspect);
+    m_focal_y = (OCCLUSION_HEIGHT * 0.5f) / tan_half_fov;
+}
+
+OcclusionBuffer::~OcclusionBuffer() {}
+
+void OcclusionBuffer::clear() {
+    std::fill(m_depth.begin(), m_depth.end(), INFINITY);
+}
+
+void OcclusionBuffer::add_occluder(SceneObject& i_object, const Camera& i_camera) {
+    std::shared_ptr<IndexedVertexData> occluder = i_object.get_occluder();
+    if (occluder == nullptr) return;
+
+    glm::mat4 mv = i_camera.GetViewMatrix() * i_object.get_model_matrix();
+    std::span<const float> vertices = occluder->get_vertex_buffer();
+    std::span<const int> indices = occluder->get_index_buffer();
+
+    std::vector<glm::vec3> view_positions;
+    view_positions.reserve(vertices.size() / 3);
+    for (size_t i = 0; i + 2 < vertices.size(); i += 3) {
+        view_positions.push_back(glm::vec3(mv * glm::vec4(vertices[i], vertices[i + 1], vertices[i + 2], 1.0f)));
+    }
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        glm::vec3 in[3] = {
+            view_positions[indices[i]],
+            view_positions[indices[i + 1]],
+            view_positions[indices[i + 2]]
+        };
+
+        /* Clip against the near plane, leaves a convex polygon of up to 4 vertices */
+        glm::vec3 poly[4];
+        int count = 0;
+        for (int k = 0; k < 3; k++) {
+            glm::vec3 a = in[k];
+            glm::vec3 b = in[(k + 1) % 3];
+            bool a_inside = a.z <= -NEAR_PLANE;
+            bool b_inside = b.z <= -NEAR_PLANE;
+            if (a_inside) poly[count++] = a;
+            if (a_inside != b_inside) {
+                float t = (-NEAR_PLANE - a.z) / (b.z - a.z);
+                poly[count++] = a + (b - a) * t;
+            }
+        }
+        if (count < 3) continue;
+
+        glm::vec3 projected[4];
+        for (int k = 0; k < count; k++) {
+            float depth = -poly[k].z;
+            projected[k] = {
+                OCCLUSION_WIDTH * 0.5f + m_focal_x * poly[k].x / depth,
+                OCCLUSION_HEIGHT * 0.5f - m_focal_y * poly[k].y / depth,
+                depth
+            };
+        }
+        for (int k = 1; k + 1 < count; k++) {
+            rasterize_triangle(projected[0], projected[k], projected[k + 1]);
+        }
+    }
+}
+
+void OcclusionBuffer::rasterize_triangle(glm::vec3 i_v1, glm::vec3 i_v2, glm::vec3 i_v3) {
+    float area = (i_v2.x - i_v1.x) * (i_v3.y - i_v1.y) - (i_v2.y - i_v1.y) * (i_v3.x - i_v1.x);
+    if (my_abs(area) < 1e-6f) return;
+    /* Wind counter-clockwise so inside is positive for all three edges */
+    if (area < 0) std::swap(i_v2, i_v3);
+
+    int min_x = std::max(0, (int)floorf(std::min(i_v1.x, std::min(i_v2.x, i_v3.x))));
+    int max_x = std::min(OCCLUSION_WIDTH - 1, (int)ceilf(std::max(i_v1.x, std::max(i_v2.x, i_v3.x))));
+    int min_y = std::max(0, (int)floorf(std::min(i_v1.y, std::min(i_v2.y, i_v3.y))));
+    int max_y = std::min(OCCLUSION_HEIGHT - 1, (int)ceilf(std::max(i_v1.y, std::max(i_v2.y, i_v3.y))));
+    if (min_x > max_x || min_y > max_y) return;
+
+    /* The whole triangle is stored at its farthest depth */
+    float depth = std::max(i_v1.z, std::max(i_v2.z, i_v3.z));
+
+    glm::vec3 verts[3] = { i_v1, i_v2, i_v3 };
+    float gx[3], gy[3], row_start[3];
+    for (int k = 0; k < 3; k++) {
+        glm::vec3 a = verts[k];
+        glm::vec3 b = verts[(k + 1) % 3];
+        gx[k] = -(b.y - a.y);
+        gy[k] = (b.x - a.x);
+        /* Sampled at texel centers, inclusive on both sides of an edge so
+           triangles sharing it leave no cracks */
+        float cx = min_x + 0.5f;
+        float cy = min_y + 0.5f;
+        row_start[k] = (cx - a.x) * gx[k] + (cy - a.y) * gy[k];
+    }
+
+    for (int y = min_y; y <= max_y; y++) {
+        float e0 = row_start[0];
+        float e1 = row_start[1];
+        float e2 = row_start[2];
+        float* depth_row = &m_depth[y * OCCLUSION_WIDTH];
+        for (int x = min_x; x <= max_x; x++) {
+            if (e0 >= 0 && e1 >= 0 && e2 >= 0 && depth < depth_row[x]) {
+                depth_row[x] = depth;
+            }
+            e0 += gx[0];
+            e1 += gx[1];
+            e2 += gx[2];
+        }
+        row_start[0] += gy[0];
+        row_start[1] += gy[1];
+        row_start[2] += gy[2];
+    }
+}
+
+bool OcclusionBuffer::is_occluded(SceneObject& i_object, const Camera& i_camera) {
+    return is_occluded(i_object.get_world_bounds_center(), i_object.get_world_bounds_radius(), i_camera);
+}
+
+bool OcclusionBuffer::is_occluded(glm::vec3 i_world_center, float i_radius, const Camera& i_camera) {
+    glm::vec3 center = glm::vec3(i_camera.GetViewMatrix() * glm::vec4(i_world_center, 1.0f));
+    float nearest = -center.z - i_radius;
+    if (nearest <= NEAR_PLANE) return false;
+
+    /* Projecting the radius at the nearest depth over-estimates the extent */
+    float cx = OCCLUSION_WIDTH * 0.5f + m_focal_x * center.x / -center.z;
+    float cy = OCCLUSION_HEIGHT * 0.5f - m_focal_y * center.y / -center.z;
+    float rx = m_focal_x * i_radius / nearest;
+    float ry = m_focal_y * i_radius / nearest;
+
+    int min_x = std::max(0, (int)floorf(cx - rx));
+    int max_x = std::min(OCCLUSION_WIDTH - 1, (int)ceilf(cx + rx));
+    int min_y = std::max(0, (int)floorf(cy - ry));
+    int max_y = std::min(OCCLUSION_HEIGHT - 1, (int)ceilf(cy + ry));
+    if (min_x > max_x || min_y > max_y) return false;
+
+    for (int y = min_y; y <= max_y; y++) {
+        float* depth_row = &m_depth[y * OCCLUSION_WIDTH];
+        for (int x = min_x; x <= max_x; x++) {
+            if (depth_row[x] >= nearest) return false;
+        }
+    }
+    return true;
+}
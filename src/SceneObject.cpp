@@ -4,7 +4,15 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 #include "ScreenGlobals.hpp"
+#include "MeshSimplifier.hpp"
+#include "Frustum.hpp"
+#include "AssetLoader.hpp"
+#include "EmbeddedMesh.hpp"
+#include "LineRasterizer.hpp"
+#include "Fog.hpp"
+#include "NormalPalette.hpp"
 #include "utils.hpp"
 
 static inline float min3(float a, float b, float c) {
@@ -33,8 +41,14 @@ static inline int abs_int(int x) {
     return x < 0 ? -x : x;
 }
 
+/* Largest axis scale of a model matrix, scales a bounding radius */
+static inline float matrix_max_scale(const glm::mat4& m) {
+    return sqrtf(std::max(glm::dot(glm::vec3(m[0]), glm::vec3(m[0])),
+        std::max(glm::dot(glm::vec3(m[1]), glm::vec3(m[1])), glm::dot(glm::vec3(m[2]), glm::vec3(m[2])))));
+}
+
 VertexData::VertexData(std::vector<float> i_vertex_buffer) {
-    m_vertex_buffer = i_vertex_buffer;
+    m_vertex_buffer = std::move(i_vertex_buffer);
 }
 
 VertexData::~VertexData() {
@@ -45,6 +59,36 @@ void VertexData::add_to_vertex_buffer(float i_f) {
     m_vertex_buffer.push_back(i_f);
 }
 
+void VertexData::compute_bounds(int i_stride) {
+    size_t buf_size = m_vertex_buffer.size();
+    if (buf_size < 3) return;
+
+    glm::vec3 min_corner{m_vertex_buffer[0], m_vertex_buffer[1], m_vertex_buffer[2]};
+    glm::vec3 max_corner = min_corner;
+    for (size_t i = 0; i + 2 < buf_size; i += i_stride) {
+        glm::vec3 p{m_vertex_buffer[i], m_vertex_buffer[i + 1], m_vertex_buffer[i + 2]};
+        min_corner = glm::min(min_corner, p);
+        max_corner = glm::max(max_corner, p);
+    }
+
+    m_bounds_center = (min_corner + max_corner) * 0.5f;
+    float radius_sqr = 0.0f;
+    for (size_t i = 0; i + 2 < buf_size; i += i_stride) {
+        glm::vec3 d = glm::vec3{m_vertex_buffer[i], m_vertex_buffer[i + 1], m_vertex_buffer[i + 2]}
+            - m_bounds_center;
+        radius_sqr = std::max(radius_sqr, glm::dot(d, d));
+    }
+    m_bounds_radius = sqrtf(radius_sqr);
+}
+
+glm::vec3 VertexData::get_bounds_center() {
+    return m_bounds_center;
+}
+
+float VertexData::get_bounds_radius() {
+    return m_bounds_radius;
+}
+
 static inline float edge(
     float ax, float ay,
     float bx, float by,
@@ -54,82 +98,6 @@ static inline float edge(
          - (py - ay) * (bx - ax);
 }
 
-void drawLineZ(PlaydateAPI* pd, 
-               std::vector<float>& depth_buffer,
-               int x0, int y0, float iz0,
-               int x1, int y1, float iz1, 
-               uint8_t color)
-{
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-    int sx = x0 < x1 ? 1 : -1;
-    int sy = y0 < y1 ? 1 : -1;
-    int err = dx - dy;
-
-    int x = x0;
-    int y = y0;
-
-    int steps = std::max(dx, dy);
-    for (int i = 0; i <= steps; i++) {
-        // Linear interpolation along the line
-        float t = steps == 0 ? 0 : (float)i / steps;
-        float iz = iz0 * (1.0f - t) + iz1 * t;
-
-        int idx = y * SCREEN_WIDTH + x;
-        if (iz > depth_buffer[idx]) {
-            depth_buffer[idx] = iz;
-            pd->graphics->setPixel(x, y, color);
-        }
-
-        int e2 = 2 * err;
-        if (e2 > -dy) { err -= dy; x += sx; }
-        if (e2 < dx)  { err += dx; y += sy; }
-    }
-}
-
-void drawLineZThick(PlaydateAPI* pd,
-                    std::vector<float>& depth_buffer,
-                    int x0, int y0, float iz0,
-                    int x1, int y1, float iz1,
-                    uint8_t color, int thickness)
-{
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-    int sx = x0 < x1 ? 1 : -1;
-    int sy = y0 < y1 ? 1 : -1;
-    int err = dx - dy;
-
-    int steps = std::max(dx, dy);
-    for (int i = 0; i <= steps; i++) {
-        float tline = steps == 0 ? 0 : (float)i / steps;
-        float iz = iz0 * (1.0f - tline) + iz1 * tline;
-
-        // Compute main pixel along the line
-        int xi = x0;
-        int yi = y0;
-
-        // Draw thick pixels perpendicular
-        for (int ox = -thickness; ox <= thickness; ox++) {
-            for (int oy = -thickness; oy <= thickness; oy++) {
-                int px = xi + ox;
-                int py = yi + oy;
-                if (px < 0 || px >= SCREEN_WIDTH || py < 0 || py >= SCREEN_HEIGHT)
-                    continue;
-
-                int idx = py * SCREEN_WIDTH + px;
-                if (iz > depth_buffer[idx]) {
-                    depth_buffer[idx] = iz;
-                    pd->graphics->setPixel(px, py, color);
-                }
-            }
-        }
-
-        int e2 = 2 * err;
-        if (e2 > -dy) { err -= dy; x0 += sx; }
-        if (e2 < dx)  { err += dx; y0 += sy; }
-    }
-}
-
 typedef struct {
     int x;           /* Current x position */
     int z;           /* Current z */
@@ -147,14 +115,16 @@ typedef struct {
     int x_end;
     int z_start;
     int z_end;
-    glm::vec3 normal_start;
-    glm::vec3 normal_end;
-    glm::vec3 normal;
+    /* Lit luminance, LIGHT_FIXED_SHIFT fixed point, stepped per scanline */
+    int intensity_start;
+    int intensity_end;
+    int intensity_step;
+    int intensity;
 } EdgeData;
 
 typedef struct ClipVert {
     float x, y, z;
-    float nx, ny, nz;
+    float intensity;   /* Lit luminance, 0 to 255 */
 } ClipVert;
 
 static inline void sort_clipvert_by_y(ClipVert *v1, ClipVert *v2, ClipVert *v3) {
@@ -186,12 +156,14 @@ static inline void setup_edge_clipvert(EdgeData* edge, ClipVert* v1, ClipVert* v
     edge->z_end = (int)(v2->z * z_scale);
 
 
-    edge->normal_start = {v1->nx, v1->ny, v1->nz};
-    edge->normal_end = {v2->nx, v2->ny, v2->nz};
+    edge->intensity_start = luminance_to_fixed(v1->intensity);
+    edge->intensity_end = luminance_to_fixed(v2->intensity);
+    int y_span = edge->y_end - edge->y_start;
+    edge->intensity_step = y_span > 0 ? (edge->intensity_end - edge->intensity_start) / y_span : 0;
 
     edge->x = edge->x_start;
     edge->z = edge->z_start;
-    edge->normal = { v1->nx, v1->ny, v1->nz };
+    edge->intensity = edge->intensity_start;
 
     edge->dx = abs(edge->x_end - edge->x_start);
     edge->sx = edge->x_start < edge->x_end ? 1 : -1;
@@ -314,7 +286,7 @@ static inline void clamp_edge(EdgeData& edge, int y_top) {
         float lt = y_span != 0 ? (float)(y_top - edge.y_start) / y_span : 0.0f;
         edge.x = my_lerp(edge.x_start, edge.x_end, lt);
         edge.z = my_lerp(edge.z_start, edge.z_end, lt);
-        edge.normal = glm::mix(edge.normal_start, edge.normal_end, lt);
+        edge.intensity = (int)my_lerp(edge.intensity_start, edge.intensity_end, lt);
     }
 }
 
@@ -326,9 +298,7 @@ static ClipVert intersect_near(ClipVert a, ClipVert b, float near_z)
     r.x = a.x + (b.x - a.x) * t;
     r.y = a.y + (b.y - a.y) * t;
     r.z = near_z;
-    r.nx = a.nx + (b.nx - a.nx) * t;
-    r.ny = a.ny + (b.ny - a.ny) * t;
-    r.nz = a.nz + (b.nz - a.nz) * t;
+    r.intensity = a.intensity + (b.intensity - a.intensity) * t;
     return r;
 }
 
@@ -413,22 +383,13 @@ float Q_rsqrt(float number)
     return y;
 }
 
-void normalize_clipvert(ClipVert* v) {
-    float mag_sqr = v->nx * v->nx + v->ny * v->ny + v->nz * v->nz;
-    float inv_sqrt = Q_rsqrt(mag_sqr);
-    //vec3s norm = { nx * inv_sqrt, ny * inv_sqrt, nz * inv_sqrt };
-    v->nx = v->nx * inv_sqrt;
-    v->ny = v->ny * inv_sqrt;
-    v->nz = v->nz * inv_sqrt;
-}
-
 /* Fill a horizontal span with integrated edge drawing */
-static inline void fill_span(PlaydateAPI* pd, int* depth_buffer, 
-    std::vector<std::vector<int>>& bayer_matrix,
+static inline void fill_span(RenderTarget& target,
+    const DitherTable& dither, const uint8_t* luminance_lut,
     int y, EdgeData& left, EdgeData& right) {
 
-    int x_start = max_int(0, left.x);
-    int x_end = min_int(SCREEN_WIDTH - 1, right.x);
+    int x_start = max_int(target.m_origin_x, left.x);
+    int x_end = min_int(target.m_origin_x + target.m_width - 1, right.x);
 
     if (x_start > x_end) return;
 
@@ -441,90 +402,209 @@ static inline void fill_span(PlaydateAPI* pd, int* depth_buffer,
     int total_dz = right.z - left.z;
     int prestep = x_start - left.x;
 
-    int idx = y * SCREEN_WIDTH + x_start;
-    int bayer_y = y & 7;
-    int bayer_x = x_start & 7;
-
-    int* bayer_row = bayer_matrix[bayer_y].data();
+    int target_y = y - target.m_origin_y;
+    int* depth_buffer = target.m_depth_buffer;
+    int idx = target_y * target.m_width + (x_start - target.m_origin_x);
+    int dither_x = x_start & 7;
 
-    const int edge_width = 1;  /* Change this to adjust edge thickness */
-    const float edge_depth_offset = 1;  /* Bring edges slightly closer */
+    const uint8_t* dither_row = dither[y & 7].data();
 
-    float norm_diff = left.normal.y - right.normal.y;
-    float dn = norm_diff / span_width;
-    float current_normal = left.normal.y + dn * prestep;
+    /* Intensity steps in fixed point, the index into the LUT is its integer part */
+    int span_pixels = right.x - left.x;
+    int di = span_pixels != 0 ? (right.intensity - left.intensity) / span_pixels : 0;
+    int intensity = left.intensity + (int)((int64_t)di * prestep);
 
-    for (int x = x_start; x <= x_end; x++, idx++, bayer_x = (bayer_x + 1) & 7) {
+    for (int x = x_start; x <= x_end; x++, idx++, dither_x = (dither_x + 1) & 7) {
         int total_dx = x - left.x;
         int z = left.z + ((total_dz * total_dx) / span_width);
 
-        /* Draw outer 2 pixels on each edge in black */
-        float brightness = (current_normal + 1) * 0.5f;
-        int lum = brightness * 255;
-        int dist_from_left = x - x_start;
-        int dist_from_right = x_end - x;
-
-        bool is_left_edge = (dist_from_left < edge_width);
-        bool is_right_edge = (dist_from_right < edge_width);
-
-        /* Edges use offset depth to always appear on top */
-        float z_to_test = (is_left_edge || is_right_edge) ?
-            z + edge_depth_offset : z;
-        if (idx < 0 || idx >= SCREEN_WIDTH * SCREEN_HEIGHT) continue;
-        if (z_to_test < depth_buffer[idx]) {
-            depth_buffer[idx] = z_to_test;
-
-            int color;
-            if (is_left_edge || is_right_edge) {
-                color = kColorBlack;
-            }
-            else {
-                color = (lum > bayer_row[bayer_x]) ? kColorWhite : kColorBlack;
-            }
-            setPixel(pd, x, y, color);
+        if (z < depth_buffer[idx]) {
+            depth_buffer[idx] = z;
+
+            int lum = intensity >> LIGHT_FIXED_SHIFT;
+            int level = apply_fog(luminance_lut[lum], z);
+            int color = (level > dither_row[dither_x]) ? kColorWhite : kColorBlack;
+            drawpixel(target.m_data, x - target.m_origin_x, target_y, target.m_rowbytes, color);
         }
-        current_normal += dn;
+        intensity += di;
     }
 }
 
-static inline void fill_spans_y(PlaydateAPI* pd, int* depth_buffer,
-    std::vector<std::vector<int>>& bayer_matrix,
+static inline void fill_spans_y(RenderTarget& target,
+    const DitherTable& dither, const uint8_t* luminance_lut,
     int y_start, int y_end, EdgeData& left, EdgeData& right) {
-    float lt_mul = 1.0f / (left.y_end - left.y_start);
-    float rt_mul = 1.0f / (right.y_end - right.y_start);
+    /* Jump both intensities to the first scanline, then step them */
+    left.intensity = left.intensity_start + (int)((int64_t)left.intensity_step * (y_start - left.y_start));
+    right.intensity = right.intensity_start + (int)((int64_t)right.intensity_step * (y_start - right.y_start));
     for (int y = y_start; y < y_end; y += 1) {
         step_edge_constant(left, y);
         step_edge_constant(right, y);
 
-        float lt = ((float)y - left.y_start) * lt_mul;
-        // left.x = my_lerp(left.x_start, left.x_end, lt);
-        // left.z = my_lerp(left.z_start, left.z_end, lt);
-        left.normal = glm::mix(left.normal_start, left.normal_end, lt);
-        float rt = ((float)y - right.y_start) * rt_mul;
-        // right.x = my_lerp(right.x_start, right.x_end, rt);
-        // right.z = my_lerp(right.z_start, right.z_end, rt);
-        right.normal = glm::mix(right.normal_start, right.normal_end, rt);
-
-        fill_span(pd, depth_buffer, bayer_matrix, y, left, right);
+        fill_span(target, dither, luminance_lut, y, left, right);
         //step_edge(left, y);
         //step_edge(right, y);
+        left.intensity += left.intensity_step;
+        right.intensity += right.intensity_step;
+    }
+}
+
+/* One byte per dither row, a set bit is a white pixel. Columns are laid out
+   in target bytes, which start origin_x pixels into the screen. */
+static inline void build_dither_pattern(const DitherTable& dither,
+    int level, int origin_x, uint8_t* o_pattern) {
+    for (int row = 0; row < 8; row++) {
+        const uint8_t* dither_row = dither[row].data();
+        uint8_t bits = 0;
+        for (int col = 0; col < 8; col++) {
+            if (level > dither_row[(col + origin_x) & 7]) {
+                bits |= 0x80 >> col;
+            }
+        }
+        o_pattern[row] = bits;
+    }
+}
+
+/* Pattern of the last flat level, neighbouring faces often share one. The
+   level is fogged once for the whole face at its centroid depth. */
+struct FlatPatternCache {
+    int m_origin_x;
+    const DitherTable* m_dither = nullptr;
+    const uint8_t* m_luminance_lut = nullptr;
+    int m_level = -1;
+    uint8_t m_pattern[8] = {};
+
+    explicit FlatPatternCache(int i_origin_x) : m_origin_x(i_origin_x) {}
+
+    void set_material(const Material& i_material) {
+        m_dither = &get_dither_table(i_material.m_dither_kernel);
+        m_luminance_lut = i_material.m_luminance_lut.data();
+        m_level = -1;
+    }
+
+    const uint8_t* operator()(float i_intensity, float i_view_depth) {
+        int level = m_luminance_lut[luminance_to_fixed(i_intensity) >> LIGHT_FIXED_SHIFT];
+        level = apply_fog_at_depth(level, i_view_depth);
+        if (level != m_level) {
+            build_dither_pattern(*m_dither, level, m_origin_x, m_pattern);
+            m_level = level;
+        }
+        return m_pattern;
+    }
+};
+
+/* Palette shading shared by every indexed mesh, one object at a time */
+static NormalPaletteCache s_palette_cache;
+
+/* Matcap of a style that shades with one, otherwise null */
+static inline const Matcap* get_style_matcap(const DrawStyle& style) {
+    if (style.m_shading_mode != ShadingMode::Matcap) return nullptr;
+    if (style.m_matcap == nullptr || !style.m_matcap->is_loaded()) return nullptr;
+    return style.m_matcap.get();
+}
+
+/* Directional luminance of a vertex, from the matcap when there is one */
+static inline float shade_normal(const Lighting& lighting, const Matcap* matcap, glm::vec3 normal) {
+    return matcap != nullptr ? matcap->shade(normal) : lighting.shade_directional(normal);
+}
+
+static inline void write_masked(uint8_t* byte, uint8_t bits, uint8_t mask) {
+    *byte = (*byte & ~mask) | (bits & mask);
+}
+
+/* Flat span, the dither row is written a byte at a time. With the depth
+   test each pixel that passes sets its bit in the byte's mask. */
+static inline void fill_span_flat(RenderTarget& target, const uint8_t* pattern,
+    bool depth_test, int y, EdgeData& left, EdgeData& right) {
+
+    int x_start = max_int(target.m_origin_x, left.x);
+    int x_end = min_int(target.m_origin_x + target.m_width - 1, right.x);
+
+    if (x_start > x_end) return;
+
+    int span_pixels = right.x - left.x;
+    if (span_pixels == 0) return;
+
+    int target_y = y - target.m_origin_y;
+    int tx_start = x_start - target.m_origin_x;
+    int tx_end = x_end - target.m_origin_x;
+    uint8_t* row = target.m_data + target_y * target.m_rowbytes;
+    uint8_t bits = pattern[y & 7];
+
+    if (!depth_test) {
+        int first_byte = tx_start >> 3;
+        int last_byte = tx_end >> 3;
+        uint8_t first_mask = 0xFF >> (tx_start & 7);
+        uint8_t last_mask = 0xFF << (7 - (tx_end & 7));
+        if (first_byte == last_byte) {
+            write_masked(&row[first_byte], bits, first_mask & last_mask);
+            return;
+        }
+        write_masked(&row[first_byte], bits, first_mask);
+        memset(&row[first_byte + 1], bits, last_byte - first_byte - 1);
+        write_masked(&row[last_byte], bits, last_mask);
+        return;
+    }
+
+    /* Depth in 16.16, steps once per pixel */
+    int* depth_row = target.m_depth_buffer + target_y * target.m_width;
+    int64_t dz = ((int64_t)(right.z - left.z) << 16) / span_pixels;
+    int64_t z = ((int64_t)left.z << 16) + dz * (x_start - left.x);
+    uint8_t mask = 0;
+    for (int tx = tx_start; tx <= tx_end; tx++, z += dz) {
+        int zi = (int)(z >> 16);
+        if (zi < depth_row[tx]) {
+            depth_row[tx] = zi;
+            mask |= 0x80 >> (tx & 7);
+        }
+        if ((tx & 7) == 7 || tx == tx_end) {
+            if (mask != 0) {
+                write_masked(&row[tx >> 3], bits, mask);
+                mask = 0;
+            }
+        }
+    }
+}
+
+static inline void fill_spans_y_flat(RenderTarget& target, const uint8_t* pattern,
+    bool depth_test, int y_start, int y_end, EdgeData& left, EdgeData& right) {
+    for (int y = y_start; y < y_end; y += 1) {
+        step_edge_constant(left, y);
+        step_edge_constant(right, y);
+
+        fill_span_flat(target, pattern, depth_test, y, left, right);
     }
 }
 
-void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection, 
-    int* depth_buffer, std::vector<std::vector<int>>& bayer_matrix) {
+void VertexData::draw([[maybe_unused]] PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection, 
+    RenderTarget& target, Lighting& lighting,
+    const DrawStyle& style) {
     glm::mat4 mv = view * model;
-    glm::mat4 mvp = projection * mv;
 
-    glm::mat3 normal_mat = glm::mat3(model);
+    /* Normals are lit in view space, where prepare put the lights */
+    glm::mat3 normal_mat = glm::mat3(mv);
     normal_mat = glm::inverse(normal_mat);
     normal_mat = glm::transpose(normal_mat);
+    lighting.prepare(view);
+    lighting.select_lights(glm::vec3(model * glm::vec4(m_bounds_center, 1.0f)),
+        m_bounds_radius * matrix_max_scale(model));
 
     float* buf = m_vertex_buffer.data();
     size_t buf_size = m_vertex_buffer.size();
+    const Material& material = *Material::get_default();
+    const uint8_t* luminance_lut = material.m_luminance_lut.data();
+    const DitherTable& dither = get_dither_table(material.m_dither_kernel);
+    bool flat = style.m_shading_mode == ShadingMode::Flat;
+    bool wireframe = style.m_shading_mode == ShadingMode::Wireframe;
+    const Matcap* matcap = get_style_matcap(style);
+    FlatPatternCache flat_pattern(target.m_origin_x);
+    flat_pattern.set_material(material);
 
     const float hw = SCREEN_WIDTH * 0.5f;
     const float hh = SCREEN_HEIGHT * 0.5f;
+    const int target_min_x = target.m_origin_x;
+    const int target_max_x = target.m_origin_x + target.m_width - 1;
+    const int target_min_y = target.m_origin_y;
+    const int target_max_y = target.m_origin_y + target.m_height - 1;
 
     for (size_t i = 0; i < buf_size; i += 18) {
         glm::vec4 pos1 = { buf[i], buf[i + 1], buf[i + 2], 1.0f };
@@ -541,8 +621,9 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
         view_pos2 = mv * pos2;
         view_pos3 = mv * pos3;
 
-        /* Z-clip */
+        /* Z-clip, faces wholly behind the camera or inside opaque fog */
         if (view_pos1.z >= 0 && view_pos2.z >= 0 && view_pos3.z >= 0) continue;
+        if (view_pos1.z < -FOG_END && view_pos2.z < -FOG_END && view_pos3.z < -FOG_END) continue;
 
         /* Backface culling */
         float e1x = view_pos2.x - view_pos1.x;
@@ -563,25 +644,46 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
 
         if (facing < 0) continue;
 
-        /* Lighting */
-
-        n1 = normal_mat * n1;
-        n2 = normal_mat * n2;
-        n3 = normal_mat * n3;
-
-        /* Fixed world-space light direction (pointing up) */
-        const float light_y = 1.0f;
+        /* Without adjacency shared edges are drawn once per face */
+        if (wireframe) {
+            draw_view_line(target, projection, view_pos1, view_pos2, style.m_line_thickness, 0);
+            draw_view_line(target, projection, view_pos2, view_pos3, style.m_line_thickness, 0);
+            draw_view_line(target, projection, view_pos3, view_pos1, style.m_line_thickness, 0);
+            continue;
+        }
 
-        /* Calculate brightness from world-space normal */
-        //float len = sqrtf(nx * nx + ny * ny + nz * nz);
-        //if (len < 0.001f) continue;
+        /* Lighting, once per vertex or once per face when flat */
 
-        //float brightness = (ny + len) * 0.5f / len;
+        float intensity1, intensity2, intensity3;
+        const uint8_t* pattern = nullptr;
+        if (flat) {
+            glm::vec3 face_normal = glm::normalize(glm::vec3(nx, ny, nz));
+            intensity1 = lighting.shade_directional(face_normal);
+            if (lighting.has_point_lights()) {
+                glm::vec3 centroid = glm::vec3(view_pos1 + view_pos2 + view_pos3) * (1.0f / 3.0f);
+                intensity1 += lighting.shade_point_lights(centroid, face_normal);
+            }
+            intensity2 = intensity1;
+            intensity3 = intensity1;
+            pattern = flat_pattern(intensity1, -(view_pos1.z + view_pos2.z + view_pos3.z) * (1.0f / 3.0f));
+        } else {
+            n1 = glm::normalize(normal_mat * n1);
+            n2 = glm::normalize(normal_mat * n2);
+            n3 = glm::normalize(normal_mat * n3);
+            intensity1 = shade_normal(lighting, matcap, n1);
+            intensity2 = shade_normal(lighting, matcap, n2);
+            intensity3 = shade_normal(lighting, matcap, n3);
+            if (lighting.has_point_lights()) {
+                intensity1 += lighting.shade_point_lights(glm::vec3(view_pos1), n1);
+                intensity2 += lighting.shade_point_lights(glm::vec3(view_pos2), n2);
+                intensity3 += lighting.shade_point_lights(glm::vec3(view_pos3), n3);
+            }
+        }
 
         ClipVert vin[3] = {
-            { view_pos1.x, view_pos1.y, view_pos1.z, n1.x, n1.y, n1.z },
-            { view_pos2.x, view_pos2.y, view_pos2.z, n2.x, n2.y, n2.z },
-            { view_pos3.x, view_pos3.y, view_pos3.z, n3.x, n3.y, n3.z }
+            { view_pos1.x, view_pos1.y, view_pos1.z, intensity1 },
+            { view_pos2.x, view_pos2.y, view_pos2.z, intensity2 },
+            { view_pos3.x, view_pos3.y, view_pos3.z, intensity3 }
         };
 
         ClipVert vout[6];
@@ -638,18 +740,14 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
             float min_y = min3(y1, y2, y3);
             float max_y = max3(y1, y2, y3);
 
-            if (max_x < 0 || min_x >= SCREEN_WIDTH ||
-                max_y < 0 || min_y >= SCREEN_HEIGHT) {
+            if (max_x < target_min_x || min_x > target_max_x ||
+                max_y < target_min_y || min_y > target_max_y) {
                 continue;  /* Triangle completely off-screen */
             }
 
-            ClipVert v1 = { x1, y1, z1, a.nx, a.ny, a.nz };
-            ClipVert v2 = { x2, y2, z2, b.nx, b.ny, b.nz };
-            ClipVert v3 = { x3, y3, z3, c.nx, c.ny, c.nz };
-
-            // normalize_clipvert(&v1);
-            // normalize_clipvert(&v2);
-            // normalize_clipvert(&v3);
+            ClipVert v1 = { x1, y1, z1, a.intensity };
+            ClipVert v2 = { x2, y2, z2, b.intensity };
+            ClipVert v3 = { x3, y3, z3, c.intensity };
 
             /* Sort vertices by Y coordinate */
             sort_clipvert_by_y(&v1, &v2, &v3);
@@ -664,8 +762,8 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
             EdgeData edge_short2; /* v2 to v3 (short edge 2) */
 
             /* Don't clamp y_min/y_max initially - use original values */
-            int y_top = max_int(0, (int)ceilf(v1.y));
-            int y_bottom = min_int(SCREEN_HEIGHT - 1, (int)floorf(v3.y));
+            int y_top = max_int(target_min_y, (int)ceilf(v1.y));
+            int y_bottom = min_int(target_max_y, (int)floorf(v3.y));
 
             /* Setup edges with original values */
             setup_edge_clipvert(&edge_long, &v1, &v3);
@@ -677,7 +775,7 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
             int middle_is_right = (v2.x > mid_x_on_long);
 
             /* Rasterize top half (v1 to v2) */
-            int y_mid = min_int(SCREEN_HEIGHT - 1, max_int(0, (int)ceilf(v2.y)));
+            int y_mid = min_int(target_max_y, max_int(target_min_y, (int)ceilf(v2.y)));
 
             //if (y_top > edge_long.y_start) {
             //    clamp_edge(edge_long, y_top);
@@ -689,7 +787,11 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
             EdgeData* left_edge = middle_is_right ? &edge_long : &edge_short1;
             EdgeData* right_edge = middle_is_right ? &edge_short1 : &edge_long;
 
-            fill_spans_y(pd, depth_buffer, bayer_matrix, y_top, y_mid, *left_edge, *right_edge);
+            if (flat) {
+                fill_spans_y_flat(target, pattern, style.m_depth_test, y_top, y_mid, *left_edge, *right_edge);
+            } else {
+                fill_spans_y(target, dither, luminance_lut, y_top, y_mid, *left_edge, *right_edge);
+            }
 
             //if (y_mid > edge_short2.y_start) {
             //    clamp_edge(edge_short2, y_mid);
@@ -699,7 +801,11 @@ void VertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::m
             left_edge = middle_is_right ? &edge_long : &edge_short2;
             right_edge = middle_is_right ? &edge_short2 : &edge_long;
 
-            fill_spans_y(pd, depth_buffer, bayer_matrix, y_mid, y_bottom + 1, *left_edge, *right_edge);
+            if (flat) {
+                fill_spans_y_flat(target, pattern, style.m_depth_test, y_mid, y_bottom + 1, *left_edge, *right_edge);
+            } else {
+                fill_spans_y(target, dither, luminance_lut, y_mid, y_bottom + 1, *left_edge, *right_edge);
+            }
         }
     }
 }
@@ -715,235 +821,586 @@ IndexedVertexData::IndexedVertexData(
     std::vector<int> i_index_buffer, 
     std::vector<float> i_normal_buffer,
     std::vector<int> i_normal_index_buffer,
-    int i_stride)  : VertexData(i_vertex_buffer) {
-    m_index_buffer = i_index_buffer;
-    m_normal_buffer = i_normal_buffer;
-    m_normal_index_buffer = i_normal_index_buffer;
+    int i_stride)  : VertexData(std::move(i_vertex_buffer)) {
+    m_index_buffer = std::move(i_index_buffer);
+    m_normal_buffer = std::move(i_normal_buffer);
+    m_normal_index_buffer = std::move(i_normal_index_buffer);
     m_stride = i_stride;
+    compute_bounds(3);
+    compute_face_planes();
+    bind_owned_buffers();
+    compute_edges();
+    quantize_normals();
+    m_material_ranges = {{0, (int)m_index_buffer.size(), Material::get_default()}};
 }
 
-IndexedVertexData::~IndexedVertexData() {
-
+IndexedVertexData::IndexedVertexData(
+    std::vector<float> i_vertex_buffer,
+    std::vector<int> i_index_buffer,
+    std::vector<float> i_normal_buffer,
+    std::vector<int> i_normal_index_buffer,
+    std::vector<glm::vec4> i_face_planes,
+    glm::vec3 i_bounds_center,
+    float i_bounds_radius,
+    int i_stride) : VertexData(std::move(i_vertex_buffer)) {
+    m_index_buffer = std::move(i_index_buffer);
+    m_normal_buffer = std::move(i_normal_buffer);
+    m_normal_index_buffer = std::move(i_normal_index_buffer);
+    m_face_planes = std::move(i_face_planes);
+    m_bounds_center = i_bounds_center;
+    m_bounds_radius = i_bounds_radius;
+    m_stride = i_stride;
+    bind_owned_buffers();
+    compute_edges();
+    quantize_normals();
+    m_material_ranges = {{0, (int)m_index_buffer.size(), Material::get_default()}};
 }
 
-void IndexedVertexData::send_to_gpu() {
-
+IndexedVertexData::IndexedVertexData(const EmbeddedMesh& i_mesh) : VertexData({}) {
+    m_vertex_view = {i_mesh.m_positions, (size_t)i_mesh.m_vertex_count * 3};
+    m_normal_view = {i_mesh.m_normals, (size_t)i_mesh.m_normal_count * 3};
+    m_index_view = {i_mesh.m_indices, (size_t)i_mesh.m_triangle_count * 3};
+    m_normal_index_view = {i_mesh.m_normal_indices, (size_t)i_mesh.m_triangle_count * 3};
+    m_face_plane_view = {i_mesh.m_face_planes, (size_t)i_mesh.m_triangle_count};
+    m_bounds_center = i_mesh.m_bounds_center;
+    m_bounds_radius = i_mesh.m_bounds_radius;
+    m_stride = 6;
+    m_material_ranges = create_material_ranges(
+        i_mesh.m_material_ranges, i_mesh.m_range_count, i_mesh.m_triangle_count);
+    if (m_material_ranges.empty()) {
+        m_material_ranges = {{0, (int)m_index_view.size(), Material::get_default()}};
+    }
+    compute_edges();
+    quantize_normals();
 }
 
-void IndexedVertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection, 
-    int* depth_buffer, std::vector<std::vector<int>>& bayer_matrix) {
-    glm::mat4 mv = view * model;
-    glm::mat4 mvp = projection * mv;
-
-    glm::mat3 normal_mat = glm::mat3(model);
-    normal_mat = glm::inverse(normal_mat);
-    normal_mat = glm::transpose(normal_mat);
-
-    float* buf = m_vertex_buffer.data();
-    size_t buf_size = m_vertex_buffer.size();
-    float* nbuf = m_normal_buffer.data();
-    size_t nbuf_size = m_normal_buffer.size();
-    int* indices = m_index_buffer.data();
-    int* norm_indices = m_normal_index_buffer.data();
-    size_t indices_size = m_index_buffer.size();
-    int stride = 3;
-
-    const float hw = SCREEN_WIDTH * 0.5f;
-    const float hh = SCREEN_HEIGHT * 0.5f;
-
-    size_t vec_size = buf_size / 3;
-    std::vector<glm::vec4> view_positions;
-    view_positions.reserve(vec_size);
-    std::vector<glm::vec3> world_normals;
-    world_normals.reserve(vec_size);
-
-    for (size_t i = 0; i < buf_size; i += stride) {
-        glm::vec4 pos1 = { buf[i], buf[i + 1], buf[i + 2], 1.0f };
-        pos1 = mv * pos1;
-        view_positions.push_back(pos1);
-    }
+void IndexedVertexData::bind_owned_buffers() {
+    m_vertex_view = m_vertex_buffer;
+    m_normal_view = m_normal_buffer;
+    m_index_view = m_index_buffer;
+    m_normal_index_view = m_normal_index_buffer;
+    m_face_plane_view = m_face_planes;
+}
 
-    for (size_t i = 0; i < nbuf_size; i += stride) {
-        glm::vec3 n1 = { nbuf[i], nbuf[i + 1], nbuf[i + 2] };
-        n1 = normal_mat * n1;
-        world_normals.push_back(n1);
-    }
+IndexedVertexData::~IndexedVertexData() {
 
-    for (size_t i = 0; i < indices_size; i += 3) {
-        int vbuf_offset1 = indices[i];
-        int vbuf_offset2 = indices[i + 1];
-        int vbuf_offset3 = indices[i + 2];
+}
 
-        glm::vec4 view_pos1, view_pos2, view_pos3;
-        view_pos1 = view_positions[vbuf_offset1];
-        view_pos2 = view_positions[vbuf_offset2];
-        view_pos3 = view_positions[vbuf_offset3];
+void IndexedVertexData::send_to_gpu() {
 
-        /* Z-clip */
-        if (view_pos1.z >= 0 && view_pos2.z >= 0 && view_pos3.z >= 0) continue;
+}
 
-        /* Backface culling */
-        float e1x = view_pos2.x - view_pos1.x;
-        float e1y = view_pos2.y - view_pos1.y;
-        float e1z = view_pos2.z - view_pos1.z;
-        float e2x = view_pos3.x - view_pos1.x;
-        float e2y = view_pos3.y - view_pos1.y;
-        float e2z = view_pos3.z - view_pos1.z;
+int IndexedVertexData::triangle_count() {
+    return m_index_view.size() / 3;
+}
 
-        float view_dir_x = -view_pos1.x;  // Camera at origin
-        float view_dir_y = -view_pos1.y;
-        float view_dir_z = -view_pos1.z;
+std::span<const float> IndexedVertexData::get_vertex_buffer() {
+    return m_vertex_view;
+}
 
-        float nx = e1y * e2z - e1z * e2y;
-        float ny = e1z * e2x - e1x * e2z;
-        float nz = e1x * e2y - e1y * e2x;
-        float facing = nx * view_dir_x + ny * view_dir_y + nz * view_dir_z;
+std::span<const int> IndexedVertexData::get_index_buffer() {
+    return m_index_view;
+}
 
-        if (facing < 0) continue;
+void IndexedVertexData::set_material_ranges(std::vector<MaterialRange> i_ranges) {
+    m_material_ranges = std::move(i_ranges);
+}
 
-        /* Lighting */
+const std::vector<MaterialRange>& IndexedVertexData::get_material_ranges() {
+    return m_material_ranges;
+}
 
-        int nbuf_offset1 = norm_indices[i];
-        int nbuf_offset2 = norm_indices[i + 1];
-        int nbuf_offset3 = norm_indices[i + 2];
+const IndexedVertexData* IndexedVertexData::get_normal_source() {
+    return m_normal_source.get();
+}
 
-        glm::vec3 n1 = world_normals[nbuf_offset1];
-        glm::vec3 n2 = world_normals[nbuf_offset2];
-        glm::vec3 n3 = world_normals[nbuf_offset3];
+std::shared_ptr<IndexedVertexData> IndexedVertexData::create_lod(float i_triangle_ratio) {
+    MeshSimplifier simplifier{m_vertex_view, m_index_view, m_normal_index_view};
+    simplifier.simplify((int)(triangle_count() * i_triangle_ratio));
+    std::shared_ptr<IndexedVertexData> lod = std::make_shared<IndexedVertexData>(
+        simplifier.get_vertex_buffer(), simplifier.get_index_buffer(),
+        std::vector<float>{}, simplifier.get_normal_index_buffer(), m_stride);
+
+    /* Borrow the normals rather than copying them. A mesh that isn't owned
+       by a shared_ptr can't be kept alive, so that one gets a copy. */
+    std::shared_ptr<IndexedVertexData> normal_source = weak_from_this().lock();
+    if (normal_source != nullptr) {
+        lod->m_normal_source = normal_source;
+        lod->m_normal_view = m_normal_view;
+    } else {
+        lod->m_normal_buffer.assign(m_normal_view.begin(), m_normal_view.end());
+        lod->m_normal_view = lod->m_normal_buffer;
+    }
+    lod->m_normal_palette_indices = m_normal_palette_indices;
+
+    /* Surviving triangles keep their order, so each source range maps to
+       a contiguous run of the simplified mesh */
+    std::vector<int> source_triangles = simplifier.get_source_triangles();
+    std::vector<MaterialRange> ranges;
+    size_t range = 0;
+    for (size_t t = 0; t < source_triangles.size(); t++) {
+        int source_index = source_triangles[t] * 3;
+        while (range + 1 < m_material_ranges.size() &&
+            source_index >= m_material_ranges[range].m_first_index + m_material_ranges[range].m_index_count) {
+            range++;
+        }
+        if (ranges.empty() || ranges.back().m_material != m_material_ranges[range].m_material) {
+            ranges.push_back({(int)t * 3, 0, m_material_ranges[range].m_material});
+        }
+        ranges.back().m_index_count += 3;
+    }
+    if (!ranges.empty()) {
+        lod->set_material_ranges(std::move(ranges));
+    }
+    return lod;
+}
 
-        ClipVert vin[3] = {
-            { view_pos1.x, view_pos1.y, view_pos1.z, n1.x, n1.y, n1.z },
-            { view_pos2.x, view_pos2.y, view_pos2.z, n2.x, n2.y, n2.z },
-            { view_pos3.x, view_pos3.y, view_pos3.z, n3.x, n3.y, n3.z }
-        };
+void IndexedVertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection, 
+    RenderTarget& target, Lighting& lighting,
+    const DrawStyle& style) {
+    prepare_draw();
+    lighting.prepare(view);
+    draw_instance(pd, model, view, projection, target, lighting, style, nullptr);
+}
 
-        ClipVert vout[6];
-        int tri_count = clip_triangle_near(vin, vout, -NEAR_PLANE); // your near plane
+void IndexedVertexData::draw(PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection,
+    RenderTarget& target, Lighting& lighting,
+    const DrawStyle& style, const BakedLighting& i_baked) {
+    prepare_draw();
+    lighting.prepare(view);
+    draw_instance(pd, model, view, projection, target, lighting, style, &i_baked);
+}
 
-        if (tri_count == 0)
-            continue;
+void IndexedVertexData::draw_instanced(PlaydateAPI* pd, std::vector<glm::mat4>& models,
+    glm::mat4& view, glm::mat4& projection,
+    RenderTarget& target, Lighting& lighting,
+    const DrawStyle& style) {
+    prepare_draw();
+    lighting.prepare(view);
+    for (glm::mat4& model : models) {
+        draw_instance(pd, model, view, projection, target, lighting, style, nullptr);
+    }
+}
 
-        for (int t = 0; t < tri_count; t++) {
+void IndexedVertexData::compute_face_planes() {
+    size_t triangle_count = m_index_buffer.size() / 3;
+    m_face_planes.resize(triangle_count);
+    for (size_t t = 0; t < triangle_count; t++) {
+        float* p1 = &m_vertex_buffer[m_index_buffer[t * 3] * 3];
+        float* p2 = &m_vertex_buffer[m_index_buffer[t * 3 + 1] * 3];
+        float* p3 = &m_vertex_buffer[m_index_buffer[t * 3 + 2] * 3];
+        glm::vec3 a{p1[0], p1[1], p1[2]};
+        glm::vec3 n = glm::cross(glm::vec3{p2[0], p2[1], p2[2]} - a, glm::vec3{p3[0], p3[1], p3[2]} - a);
+        m_face_planes[t] = glm::vec4(n, -glm::dot(n, a));
+    }
+}
 
-            ClipVert a = vout[t * 3 + 0];
-            ClipVert b = vout[t * 3 + 1];
-            ClipVert c = vout[t * 3 + 2];
+void IndexedVertexData::compute_edges() {
+    /* Each triangle side keyed by its vertex pair, sorting puts the faces
+       that share an edge next to each other */
+    size_t triangle_count = m_index_view.size() / 3;
+    std::vector<std::pair<uint64_t, int>> sides;
+    sides.reserve(triangle_count * 3);
+    for (size_t t = 0; t < triangle_count; t++) {
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = m_index_view[t * 3 + k];
+            uint32_t b = m_index_view[t * 3 + (k + 1) % 3];
+            if (a == b) continue;
+            uint64_t key = a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+            sides.push_back({key, (int)t});
+        }
+    }
+    std::sort(sides.begin(), sides.end());
+
+    float cos_crease = cosf(glm::radians(OUTLINE_CREASE_DEGREES));
+    m_edges.clear();
+    for (size_t i = 0; i < sides.size(); ) {
+        MeshEdge edge;
+        edge.m_vertices[0] = (int)(sides[i].first >> 32);
+        edge.m_vertices[1] = (int)(sides[i].first & 0xFFFFFFFF);
+        edge.m_faces[0] = sides[i].second;
+        edge.m_faces[1] = -1;
+        edge.m_crease = false;
+        /* A third face on the same edge starts an edge of its own */
+        if (i + 1 < sides.size() && sides[i + 1].first == sides[i].first) {
+            edge.m_faces[1] = sides[i + 1].second;
+            glm::vec3 n0 = glm::vec3(m_face_plane_view[edge.m_faces[0]]);
+            glm::vec3 n1 = glm::vec3(m_face_plane_view[edge.m_faces[1]]);
+            float lengths = glm::length(n0) * glm::length(n1);
+            edge.m_crease = lengths > 0.0f && glm::dot(n0, n1) < cos_crease * lengths;
+            i += 2;
+        } else {
+            i += 1;
+        }
+        m_edges.push_back(edge);
+    }
+}
 
-            /* Use a,b,c as your new triangle */
-            /* Continue pipeline from here */
+void IndexedVertexData::quantize_normals() {
+    size_t normal_count = m_normal_view.size() / 3;
+    m_normal_palette_indices.resize(normal_count);
+    for (size_t n = 0; n < normal_count; n++) {
+        m_normal_palette_indices[n] = encode_palette_normal(
+            glm::vec3{ m_normal_view[n * 3], m_normal_view[n * 3 + 1], m_normal_view[n * 3 + 2] });
+    }
+    m_face_palette_indices.resize(m_face_plane_view.size());
+    for (size_t t = 0; t < m_face_plane_view.size(); t++) {
+        m_face_palette_indices[t] = encode_palette_normal(glm::vec3(m_face_plane_view[t]));
+    }
+}
 
-            view_pos1 = { a.x, a.y, a.z, 1.0f };
-            view_pos2 = { b.x, b.y, b.z, 1.0f };
-            view_pos3 = { c.x, c.y, c.z, 1.0f };
+void IndexedVertexData::bake_lighting(const glm::mat4& i_model, Lighting& i_lighting, float i_occlusion,
+    BakedLighting& o_baked) {
+    size_t vertex_count = m_vertex_view.size() / 3;
+    size_t triangle_count = m_index_view.size() / 3;
+    auto position = [this](int v) {
+        return glm::vec3{ m_vertex_view[v * 3], m_vertex_view[v * 3 + 1], m_vertex_view[v * 3 + 2] };
+    };
+
+    /* Occlusion from the one-ring: the more a vertex's neighbours rise
+       above the plane of its area-weighted normal, the deeper the cavity */
+    std::vector<float> occlusion(vertex_count, 1.0f);
+    if (i_occlusion > 0.0f) {
+        std::vector<glm::vec3> vertex_normals(vertex_count, glm::vec3(0.0f));
+        for (size_t t = 0; t < triangle_count; t++) {
+            for (int k = 0; k < 3; k++) {
+                vertex_normals[m_index_view[t * 3 + k]] += glm::vec3(m_face_plane_view[t]);
+            }
+        }
+        std::vector<float> cavity(vertex_count, 0.0f);
+        std::vector<int> neighbours(vertex_count, 0);
+        for (size_t t = 0; t < triangle_count; t++) {
+            for (int k = 0; k < 3; k++) {
+                int v = m_index_view[t * 3 + k];
+                float length = glm::length(vertex_normals[v]);
+                if (length <= 0.0f) continue;
+                for (int j = 1; j < 3; j++) {
+                    glm::vec3 to_neighbour = position(m_index_view[t * 3 + (k + j) % 3]) - position(v);
+                    float distance = glm::length(to_neighbour);
+                    if (distance <= 0.0f) continue;
+                    float rise = glm::dot(vertex_normals[v], to_neighbour) / (length * distance);
+                    cavity[v] += rise > 0.0f ? rise : 0.0f;
+                    neighbours[v]++;
+                }
+            }
+        }
+        for (size_t v = 0; v < vertex_count; v++) {
+            if (neighbours[v] > 0) occlusion[v] = 1.0f - i_occlusion * cavity[v] / neighbours[v];
+        }
+    }
 
-            /* Project to screen space */
-            glm::vec4 clip1, clip2, clip3;
-            clip1 = projection * view_pos1;
-            clip2 = projection * view_pos2;
-            clip3 = projection * view_pos3;
+    /* An identity view puts the directional light in world space */
+    i_lighting.prepare(glm::mat4(1.0f));
+    glm::mat3 normal_mat = glm::transpose(glm::inverse(glm::mat3(i_model)));
+    o_baked.m_corner_intensities.resize(m_index_view.size());
+    for (size_t i = 0; i < m_index_view.size(); i++) {
+        int n = m_normal_index_view[i];
+        glm::vec3 normal = glm::normalize(normal_mat * glm::vec3{ m_normal_view[n * 3], m_normal_view[n * 3 + 1], m_normal_view[n * 3 + 2] });
+        o_baked.m_corner_intensities[i] = i_lighting.shade_directional(normal) * occlusion[m_index_view[i]];
+    }
+    o_baked.m_face_intensities.resize(triangle_count);
+    for (size_t t = 0; t < triangle_count; t++) {
+        glm::vec3 normal = glm::normalize(normal_mat * glm::vec3(m_face_plane_view[t]));
+        float face_occlusion = (occlusion[m_index_view[t * 3]] + occlusion[m_index_view[t * 3 + 1]]
+            + occlusion[m_index_view[t * 3 + 2]]) * (1.0f / 3.0f);
+        o_baked.m_face_intensities[t] = i_lighting.shade_directional(normal) * face_occlusion;
+    }
+}
 
-            float inv_w1 = 1.0f / clip1.w;
-            float inv_w2 = 1.0f / clip2.w;
-            float inv_w3 = 1.0f / clip3.w;
+void IndexedVertexData::prepare_draw() {
+    /* Per-mesh scratch, sized once and shared by every instance */
+    size_t vertex_count = m_vertex_view.size() / 3;
+    if (m_view_positions.size() != vertex_count) {
+        m_view_positions.resize(vertex_count);
+        m_vertex_stamps.assign(vertex_count, 0);
+    }
+    if (m_face_front.size() != m_face_plane_view.size()) {
+        m_face_front.resize(m_face_plane_view.size());
+    }
+}
 
-            float x1 = (clip1.x * inv_w1 + 1.0f) * hw;
-            float y1 = (1.0f - clip1.y * inv_w1) * hh;
-            float x2 = (clip2.x * inv_w2 + 1.0f) * hw;
-            float y2 = (1.0f - clip2.y * inv_w2) * hh;
-            float x3 = (clip3.x * inv_w3 + 1.0f) * hw;
-            float y3 = (1.0f - clip3.y * inv_w3) * hh;
+void IndexedVertexData::draw_instance([[maybe_unused]] PlaydateAPI* pd, glm::mat4& model, glm::mat4& view, glm::mat4& projection, 
+    RenderTarget& target, Lighting& lighting,
+    const DrawStyle& style, const BakedLighting* i_baked) {
+    glm::mat4 mv = view * model;
 
-            // After projection and screen transform
-            //float z1 = 1.0f / -view_pos1.z;  // Use reciprocal of view Z
-            //float z2 = 1.0f / -view_pos2.z;
-            //float z3 = 1.0f / -view_pos3.z;
-            float z1 = clip1.z * inv_w1;
-            float z2 = clip2.z * inv_w2;
-            float z3 = clip3.z * inv_w3;
+    /* Normals are lit in view space, where prepare put the lights */
+    glm::mat3 normal_mat = glm::mat3(mv);
+    normal_mat = glm::inverse(normal_mat);
+    normal_mat = glm::transpose(normal_mat);
 
-            z1 = z1 * 0.5f + 0.5f;
-            z2 = z2 * 0.5f + 0.5f;
-            z3 = z3 * 0.5f + 0.5f;
+    /* Only the point lights that reach this instance's bounds */
+    lighting.select_lights(glm::vec3(model * glm::vec4(m_bounds_center, 1.0f)),
+        m_bounds_radius * matrix_max_scale(model));
+    bool point_lights = lighting.has_point_lights();
 
+    /* Backface test against object-space face planes, flipped for mirroring transforms */
+    glm::vec3 eye = glm::vec3(glm::inverse(mv)[3]);
+    float orientation = glm::determinant(glm::mat3(model)) < 0 ? -1.0f : 1.0f;
 
-            float min_x = min3(x1, x2, x3);
-            float max_x = max3(x1, x2, x3);
-            float min_y = min3(y1, y2, y3);
-            float max_y = max3(y1, y2, y3);
+    const float* buf = m_vertex_view.data();
+    const int* indices = m_index_view.data();
+    const int* norm_indices = m_normal_index_view.data();
+    const glm::vec4* face_planes = m_face_plane_view.data();
 
-            if (max_x < 0 || min_x >= SCREEN_WIDTH ||
-                max_y < 0 || min_y >= SCREEN_HEIGHT) {
-                continue;  /* Triangle completely off-screen */
+    const float hw = SCREEN_WIDTH * 0.5f;
+    const float hh = SCREEN_HEIGHT * 0.5f;
+    const int target_min_x = target.m_origin_x;
+    const int target_max_x = target.m_origin_x + target.m_width - 1;
+    const int target_min_y = target.m_origin_y;
+    const int target_max_y = target.m_origin_y + target.m_height - 1;
+
+    /* Vertices are transformed lazily, only when a front face uses them.
+       Normals are palette entries, the directional part of the lighting
+       depends on the normal alone and is shaded once per entry. */
+    int stamp = ++m_draw_stamp;
+    glm::vec4* view_positions = m_view_positions.data();
+    int* vertex_stamps = m_vertex_stamps.data();
+    uint8_t* face_front = m_face_front.data();
+    const uint16_t* normal_palette_indices = m_normal_palette_indices.data();
+    const uint16_t* face_palette_indices = m_face_palette_indices.data();
+
+    bool flat = style.m_shading_mode == ShadingMode::Flat;
+    bool wireframe = style.m_shading_mode == ShadingMode::Wireframe;
+    /* Flat faces are lit by the directional light, not the matcap */
+    const Matcap* matcap = flat ? nullptr : get_style_matcap(style);
+    s_palette_cache.begin(normal_mat, lighting, matcap);
+    /* A matcap depends on the view, so it can't be baked */
+    bool baked = i_baked != nullptr && matcap == nullptr;
+    const float* baked_corners = baked ? i_baked->m_corner_intensities.data() : nullptr;
+    const float* baked_faces = baked ? i_baked->m_face_intensities.data() : nullptr;
+    FlatPatternCache flat_pattern(target.m_origin_x);
+
+    for (MaterialRange& range : m_material_ranges) {
+        const uint8_t* luminance_lut = range.m_material->m_luminance_lut.data();
+        const DitherTable& dither = get_dither_table(range.m_material->m_dither_kernel);
+        flat_pattern.set_material(*range.m_material);
+        size_t range_end = range.m_first_index + range.m_index_count;
+        for (size_t i = range.m_first_index; i < range_end; i += 3) {
+            glm::vec4 plane = face_planes[i / 3];
+            float facing = plane.x * eye.x + plane.y * eye.y + plane.z * eye.z + plane.w;
+            face_front[i / 3] = facing * orientation >= 0;
+            if (!face_front[i / 3]) continue;
+
+            int vbuf_offset1 = indices[i];
+            int vbuf_offset2 = indices[i + 1];
+            int vbuf_offset3 = indices[i + 2];
+            int offsets[3] = { vbuf_offset1, vbuf_offset2, vbuf_offset3 };
+            for (int k = 0; k < 3; k++) {
+                int v = offsets[k];
+                if (vertex_stamps[v] == stamp) continue;
+                vertex_stamps[v] = stamp;
+                view_positions[v] = mv * glm::vec4{ buf[v * 3], buf[v * 3 + 1], buf[v * 3 + 2], 1.0f };
+            }
+            /* Only the edge pass below draws wireframes */
+            if (wireframe) continue;
+
+            glm::vec4 view_pos1, view_pos2, view_pos3;
+            view_pos1 = view_positions[vbuf_offset1];
+            view_pos2 = view_positions[vbuf_offset2];
+            view_pos3 = view_positions[vbuf_offset3];
+
+            /* Z-clip, faces wholly behind the camera or inside opaque fog */
+            if (view_pos1.z >= 0 && view_pos2.z >= 0 && view_pos3.z >= 0) continue;
+            if (view_pos1.z < -FOG_END && view_pos2.z < -FOG_END && view_pos3.z < -FOG_END) continue;
+
+            /* Lighting, once per vertex or once per face when flat */
+
+            float intensity1, intensity2, intensity3;
+            const uint8_t* pattern = nullptr;
+            if (flat) {
+                uint16_t face_entry = face_palette_indices[i / 3];
+                intensity1 = baked ? baked_faces[i / 3] : s_palette_cache.shade(face_entry);
+                if (point_lights) {
+                    glm::vec3 centroid = glm::vec3(view_pos1 + view_pos2 + view_pos3) * (1.0f / 3.0f);
+                    intensity1 += lighting.shade_point_lights(centroid, s_palette_cache.get_view_normal(face_entry));
+                }
+                intensity2 = intensity1;
+                intensity3 = intensity1;
+                pattern = flat_pattern(intensity1, -(view_pos1.z + view_pos2.z + view_pos3.z) * (1.0f / 3.0f));
+            } else {
+                uint16_t entry1 = normal_palette_indices[norm_indices[i]];
+                uint16_t entry2 = normal_palette_indices[norm_indices[i + 1]];
+                uint16_t entry3 = normal_palette_indices[norm_indices[i + 2]];
+                if (baked) {
+                    intensity1 = baked_corners[i];
+                    intensity2 = baked_corners[i + 1];
+                    intensity3 = baked_corners[i + 2];
+                } else {
+                    intensity1 = s_palette_cache.shade(entry1);
+                    intensity2 = s_palette_cache.shade(entry2);
+                    intensity3 = s_palette_cache.shade(entry3);
+                }
+                if (point_lights) {
+                    intensity1 += lighting.shade_point_lights(glm::vec3(view_pos1), s_palette_cache.get_view_normal(entry1));
+                    intensity2 += lighting.shade_point_lights(glm::vec3(view_pos2), s_palette_cache.get_view_normal(entry2));
+                    intensity3 += lighting.shade_point_lights(glm::vec3(view_pos3), s_palette_cache.get_view_normal(entry3));
+                }
             }
 
-            ClipVert v1 = { x1, y1, z1, a.nx, a.ny, a.nz };
-            ClipVert v2 = { x2, y2, z2, b.nx, b.ny, b.nz };
-            ClipVert v3 = { x3, y3, z3, c.nx, c.ny, c.nz };
+            ClipVert vin[3] = {
+                { view_pos1.x, view_pos1.y, view_pos1.z, intensity1 },
+                { view_pos2.x, view_pos2.y, view_pos2.z, intensity2 },
+                { view_pos3.x, view_pos3.y, view_pos3.z, intensity3 }
+            };
+
+            ClipVert vout[6];
+            int tri_count = clip_triangle_near(vin, vout, -NEAR_PLANE); // your near plane
+
+            if (tri_count == 0)
+                continue;
+
+            for (int t = 0; t < tri_count; t++) {
+
+                ClipVert a = vout[t * 3 + 0];
+                ClipVert b = vout[t * 3 + 1];
+                ClipVert c = vout[t * 3 + 2];
+
+                /* Use a,b,c as your new triangle */
+                /* Continue pipeline from here */
+
+                view_pos1 = { a.x, a.y, a.z, 1.0f };
+                view_pos2 = { b.x, b.y, b.z, 1.0f };
+                view_pos3 = { c.x, c.y, c.z, 1.0f };
+
+                /* Project to screen space */
+                glm::vec4 clip1, clip2, clip3;
+                clip1 = projection * view_pos1;
+                clip2 = projection * view_pos2;
+                clip3 = projection * view_pos3;
+
+                float inv_w1 = 1.0f / clip1.w;
+                float inv_w2 = 1.0f / clip2.w;
+                float inv_w3 = 1.0f / clip3.w;
+
+                float x1 = (clip1.x * inv_w1 + 1.0f) * hw;
+                float y1 = (1.0f - clip1.y * inv_w1) * hh;
+                float x2 = (clip2.x * inv_w2 + 1.0f) * hw;
+                float y2 = (1.0f - clip2.y * inv_w2) * hh;
+                float x3 = (clip3.x * inv_w3 + 1.0f) * hw;
+                float y3 = (1.0f - clip3.y * inv_w3) * hh;
+
+                // After projection and screen transform
+                //float z1 = 1.0f / -view_pos1.z;  // Use reciprocal of view Z
+                //float z2 = 1.0f / -view_pos2.z;
+                //float z3 = 1.0f / -view_pos3.z;
+                float z1 = clip1.z * inv_w1;
+                float z2 = clip2.z * inv_w2;
+                float z3 = clip3.z * inv_w3;
+
+                z1 = z1 * 0.5f + 0.5f;
+                z2 = z2 * 0.5f + 0.5f;
+                z3 = z3 * 0.5f + 0.5f;
+
+
+                float min_x = min3(x1, x2, x3);
+                float max_x = max3(x1, x2, x3);
+                float min_y = min3(y1, y2, y3);
+                float max_y = max3(y1, y2, y3);
+
+                if (max_x < target_min_x || min_x > target_max_x ||
+                    max_y < target_min_y || min_y > target_max_y) {
+                    continue;  /* Triangle completely off-screen */
+                }
 
-            // normalize_clipvert(&v1);
-            // normalize_clipvert(&v2);
-            // normalize_clipvert(&v3);
+                ClipVert v1 = { x1, y1, z1, a.intensity };
+                ClipVert v2 = { x2, y2, z2, b.intensity };
+                ClipVert v3 = { x3, y3, z3, c.intensity };
 
-            /* Sort vertices by Y coordinate */
-            sort_clipvert_by_y(&v1, &v2, &v3);
-            //sort_vertices_by_y(&x1, &y1, &z1, &x2, &y2, &z2, &x3, &y3, &z3);
+                /* Sort vertices by Y coordinate */
+                sort_clipvert_by_y(&v1, &v2, &v3);
+                //sort_vertices_by_y(&x1, &y1, &z1, &x2, &y2, &z2, &x3, &y3, &z3);
 
-            /* Check for degenerate triangle */
-            if (my_abs(v3.y - v1.y) < 0.001f) continue;
+                /* Check for degenerate triangle */
+                if (my_abs(v3.y - v1.y) < 0.001f) continue;
 
-            /* Setup edges */
-            EdgeData edge_long;   /* v1 to v3 (long edge) */
-            EdgeData edge_short1; /* v1 to v2 (short edge 1) */
-            EdgeData edge_short2; /* v2 to v3 (short edge 2) */
+                /* Setup edges */
+                EdgeData edge_long;   /* v1 to v3 (long edge) */
+                EdgeData edge_short1; /* v1 to v2 (short edge 1) */
+                EdgeData edge_short2; /* v2 to v3 (short edge 2) */
 
-            /* Don't clamp y_min/y_max initially - use original values */
-            int y_top = max_int(0, (int)ceilf(v1.y));
-            int y_bottom = min_int(SCREEN_HEIGHT - 1, (int)floorf(v3.y));
+                /* Don't clamp y_min/y_max initially - use original values */
+                int y_top = max_int(target_min_y, (int)ceilf(v1.y));
+                int y_bottom = min_int(target_max_y, (int)floorf(v3.y));
 
-            /* Setup edges with original values */
-            setup_edge_clipvert(&edge_long, &v1, &v3);
-            setup_edge_clipvert(&edge_short1, &v1, &v2);
-            setup_edge_clipvert(&edge_short2, &v2, &v3);
+                /* Setup edges with original values */
+                setup_edge_clipvert(&edge_long, &v1, &v3);
+                setup_edge_clipvert(&edge_short1, &v1, &v2);
+                setup_edge_clipvert(&edge_short2, &v2, &v3);
 
-            /* Determine which side the middle vertex is on */
-            float mid_x_on_long = v1.x + (v3.x - v1.x) * (v2.y - v1.y) / (v3.y - v1.y);
-            int middle_is_right = (v2.x > mid_x_on_long);
+                /* Determine which side the middle vertex is on */
+                float mid_x_on_long = v1.x + (v3.x - v1.x) * (v2.y - v1.y) / (v3.y - v1.y);
+                int middle_is_right = (v2.x > mid_x_on_long);
 
-            /* Rasterize top half (v1 to v2) */
-            int y_mid = min_int(SCREEN_HEIGHT - 1, max_int(0, (int)ceilf(v2.y)));
+                /* Rasterize top half (v1 to v2) */
+                int y_mid = min_int(target_max_y, max_int(target_min_y, (int)ceilf(v2.y)));
 
-            //if (y_top > edge_long.y_start) {
-            //    clamp_edge(edge_long, y_top);
-            //}
-            //if (y_top > edge_short1.y_start) {
-            //    clamp_edge(edge_short1, y_top);
-            //}
+                //if (y_top > edge_long.y_start) {
+                //    clamp_edge(edge_long, y_top);
+                //}
+                //if (y_top > edge_short1.y_start) {
+                //    clamp_edge(edge_short1, y_top);
+                //}
 
-            EdgeData* left_edge = middle_is_right ? &edge_long : &edge_short1;
-            EdgeData* right_edge = middle_is_right ? &edge_short1 : &edge_long;
+                EdgeData* left_edge = middle_is_right ? &edge_long : &edge_short1;
+                EdgeData* right_edge = middle_is_right ? &edge_short1 : &edge_long;
 
-            fill_spans_y(pd, depth_buffer, bayer_matrix, y_top, y_mid, *left_edge, *right_edge);
+                if (flat) {
+                    fill_spans_y_flat(target, pattern, style.m_depth_test, y_top, y_mid, *left_edge, *right_edge);
+                } else {
+                    fill_spans_y(target, dither, luminance_lut, y_top, y_mid, *left_edge, *right_edge);
+                }
 
-            //if (y_mid > edge_short2.y_start) {
-            //    clamp_edge(edge_short2, y_mid);
-            //}
+                //if (y_mid > edge_short2.y_start) {
+                //    clamp_edge(edge_short2, y_mid);
+                //}
 
-            /* Rasterize bottom half (v2 to v3) */
-            left_edge = middle_is_right ? &edge_long : &edge_short2;
-            right_edge = middle_is_right ? &edge_short2 : &edge_long;
+                /* Rasterize bottom half (v2 to v3) */
+                left_edge = middle_is_right ? &edge_long : &edge_short2;
+                right_edge = middle_is_right ? &edge_short2 : &edge_long;
 
-            fill_spans_y(pd, depth_buffer, bayer_matrix, y_mid, y_bottom + 1, *left_edge, *right_edge);
+                if (flat) {
+                    fill_spans_y_flat(target, pattern, style.m_depth_test, y_mid, y_bottom + 1, *left_edge, *right_edge);
+                } else {
+                    fill_spans_y(target, dither, luminance_lut, y_mid, y_bottom + 1, *left_edge, *right_edge);
+                }
+            }
+        }
+    }
+
+    /* Wireframes draw every edge of a front face. Outlines draw
+       silhouettes, where a front face meets a back face or the mesh is
+       open, and creases between two front faces. */
+    if (wireframe || style.m_outlines) {
+        for (const MeshEdge& edge : m_edges) {
+            bool front0 = face_front[edge.m_faces[0]];
+            bool front1 = edge.m_faces[1] >= 0 && face_front[edge.m_faces[1]];
+            if (wireframe) {
+                if (!front0 && !front1) continue;
+            } else if (front0 == front1 && !(front0 && edge.m_crease)) {
+                continue;
+            }
+            draw_view_line(target, projection,
+                view_positions[edge.m_vertices[0]], view_positions[edge.m_vertices[1]],
+                style.m_line_thickness, OUTLINE_DEPTH_BIAS);
         }
     }
 }
 
+static int s_next_object_id = 0;
+
 SceneObject::SceneObject(std::shared_ptr<VertexData> i_vertex_data) {
     m_vertex_data = i_vertex_data;
-    
+    m_id = ++s_next_object_id;
 }
 
 SceneObject::SceneObject() {
     m_vertex_data = nullptr;
+    m_id = ++s_next_object_id;
+}
+
+int SceneObject::get_id() const {
+    return m_id;
 }
 
 SceneObject::~SceneObject() {
@@ -955,22 +1412,191 @@ void SceneObject::send_vertex_data_to_gpu() {
     m_vertex_data->send_to_gpu();
 }
 
-void SceneObject::draw(const Camera& i_camera, PlaydateAPI* pd, int* depth_buffer,
-    std::vector<std::vector<int>>& bayer_matrix) {
+void SceneObject::draw(const Camera& i_camera, PlaydateAPI* pd, RenderTarget& target,
+    Lighting& lighting) {
+    if (!is_loaded()) return;
+
+    glm::mat4 model = get_model_matrix();
+    glm::mat4 view = i_camera.GetViewMatrix();
+    glm::mat4 perspective = get_projection_matrix();
+
+    /* Whole object inside opaque fog */
+    glm::vec4 view_center = view * glm::vec4(get_world_bounds_center(), 1.0f);
+    if (-view_center.z - get_world_bounds_radius() > FOG_END) return;
+
+    if (has_baked_lighting() && (&lighting != m_baked_lights || model != m_baked_model
+        || lighting.get_directional_generation() != m_baked_light_generation)) {
+        clear_baked_lighting();
+    }
+
+    std::shared_ptr<VertexData> vertex_data = m_vertex_data;
+    if (!m_lods.empty() || m_draw_style.m_wireframe_screen_radius > 0.0f) {
+        glm::mat4 mv = view * model;
+        float screen_radius = get_screen_radius(mv);
+        if (!m_lods.empty()) {
+            select_lod(screen_radius);
+            if (m_current_lod > 0) {
+                vertex_data = m_lods[m_current_lod - 1];
+            }
+        }
+        if (screen_radius < m_draw_style.m_wireframe_screen_radius) {
+            DrawStyle wireframe_style = m_draw_style;
+            wireframe_style.m_shading_mode = ShadingMode::Wireframe;
+            vertex_data->draw(pd, model, view, perspective, target, lighting, wireframe_style);
+            return;
+        }
+    }
+    /* Only IndexedVertexData levels get a non-empty bake */
+    if (has_baked_lighting() && !m_baked_lighting[m_current_lod].m_face_intensities.empty()) {
+        static_cast<IndexedVertexData&>(*vertex_data).draw(pd, model, view, perspective, target, lighting,
+            m_draw_style, m_baked_lighting[m_current_lod]);
+        return;
+    }
+    vertex_data->draw(pd, model, view, perspective, target, lighting, m_draw_style);
+}
+
+static glm::mat4 transform_to_model(Transform& i_tf) {
     // glm::mat4 model = glm::translate(glm::mat4(1.0f), m_transform.m_position);
     // model = model * glm::mat4_cast(m_transform.m_rotation);
     // model = glm::scale(model, m_transform.m_scale);
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), m_transform.m_position)
-                * glm::mat4_cast(m_transform.m_rotation)
-                * glm::scale(glm::mat4(1.0f), m_transform.m_scale);
+    return glm::translate(glm::mat4(1.0f), i_tf.m_position)
+        * glm::mat4_cast(i_tf.m_rotation)
+        * glm::scale(glm::mat4(1.0f), i_tf.m_scale);
+}
 
-    glm::mat4 view = i_camera.GetViewMatrix();
-    glm::mat4 perspective = glm::perspective(
-        glm::radians(45.0f),
+static float transform_max_scale(Transform& i_tf) {
+    return std::max(my_abs(i_tf.m_scale.x),
+        std::max(my_abs(i_tf.m_scale.y), my_abs(i_tf.m_scale.z)));
+}
+
+glm::mat4 SceneObject::get_model_matrix() {
+    return transform_to_model(m_transform);
+}
+
+glm::mat4 SceneObject::get_projection_matrix() {
+    return glm::perspective(
+        glm::radians(FIELD_OF_VIEW_DEGREES),
         (float)SCREEN_WIDTH/(float)SCREEN_HEIGHT,
         NEAR_PLANE,
-        1000.0f);
-    m_vertex_data->draw(pd, model, view, perspective, depth_buffer, bayer_matrix);
+        FAR_PLANE);
+}
+
+glm::vec3 SceneObject::get_world_bounds_center() {
+    if (!is_loaded()) return m_transform.m_position;
+    return glm::vec3(get_model_matrix() * glm::vec4(m_vertex_data->get_bounds_center(), 1.0f));
+}
+
+float SceneObject::get_world_bounds_radius() {
+    if (!is_loaded()) return 0.0f;
+    return m_vertex_data->get_bounds_radius() * transform_max_scale(m_transform);
+}
+
+float SceneObject::get_screen_radius(glm::mat4& i_model_view) {
+    glm::vec4 view_center = i_model_view * glm::vec4(m_vertex_data->get_bounds_center(), 1.0f);
+    float radius = get_world_bounds_radius();
+    float distance = glm::length(glm::vec3(view_center));
+
+    /* Camera inside the bounds, always use full detail */
+    if (distance <= radius) return INFINITY;
+
+    return radius * get_screen_focal_length() / distance;
+}
+
+float SceneObject::get_screen_focal_length() {
+    return (SCREEN_HEIGHT * 0.5f) / tanf(glm::radians(FIELD_OF_VIEW_DEGREES) * 0.5f);
+}
+
+void SceneObject::select_lod(float i_screen_radius) {
+    /* Thresholds have to be overshot by LOD_HYSTERESIS in either direction */
+    while (m_current_lod < (int)m_lods.size() &&
+           i_screen_radius < m_lod_screen_radii[m_current_lod] * (1.0f - LOD_HYSTERESIS)) {
+        m_current_lod++;
+    }
+    while (m_current_lod > 0 &&
+           i_screen_radius > m_lod_screen_radii[m_current_lod - 1] * (1.0f + LOD_HYSTERESIS)) {
+        m_current_lod--;
+    }
+}
+
+void SceneObject::add_lod(std::shared_ptr<VertexData> i_vertex_data, float i_max_screen_radius) {
+    clear_baked_lighting();
+    m_lods.push_back(i_vertex_data);
+    m_lod_screen_radii.push_back(i_max_screen_radius);
+}
+
+void SceneObject::generate_lods(int i_lod_count) {
+    std::shared_ptr<IndexedVertexData> indexed =
+        std::dynamic_pointer_cast<IndexedVertexData>(m_vertex_data);
+    if (indexed == nullptr) return;
+
+    for (int i = 0; i < i_lod_count; i++) {
+        float triangle_ratio = get_lod_triangle_ratio(i);
+        if (indexed->triangle_count() * triangle_ratio < LOD_MIN_TRIANGLES) break;
+        add_lod(indexed->create_lod(triangle_ratio), get_lod_screen_radius(i));
+    }
+}
+
+int SceneObject::get_current_lod() {
+    return m_current_lod;
+}
+
+float SceneObject::get_lod_triangle_ratio(int i_level) {
+    return ldexpf(1.0f, -(i_level + 1));
+}
+
+float SceneObject::get_lod_screen_radius(int i_level) {
+    return ldexpf(LOD_BASE_SCREEN_RADIUS, -i_level);
+}
+
+void SceneObject::set_mesh_handle(std::shared_ptr<MeshHandle> i_handle) {
+    m_mesh_handle = i_handle;
+    m_vertex_data = nullptr;
+    m_lods.clear();
+    m_lod_screen_radii.clear();
+    m_current_lod = 0;
+    clear_baked_lighting();
+}
+
+bool SceneObject::is_loaded() {
+    if (m_vertex_data == nullptr && m_mesh_handle != nullptr && m_mesh_handle->m_ready) {
+        m_vertex_data = m_mesh_handle->m_vertex_data;
+        for (size_t i = 0; i < m_mesh_handle->m_lods.size(); i++) {
+            add_lod(m_mesh_handle->m_lods[i], m_mesh_handle->m_lod_screen_radii[i]);
+        }
+        m_mesh_handle = nullptr;
+    }
+    return m_vertex_data != nullptr;
+}
+
+void SceneObject::set_occluder(std::shared_ptr<IndexedVertexData> i_occluder) {
+    m_occluder = i_occluder;
+}
+
+std::shared_ptr<IndexedVertexData> SceneObject::get_occluder() {
+    return m_occluder;
+}
+
+void SceneObject::bake_lighting(Lighting& i_lighting, float i_occlusion) {
+    if (!is_loaded()) return;
+    glm::mat4 model = get_model_matrix();
+    m_baked_lighting.assign(m_lods.size() + 1, BakedLighting{});
+    for (size_t level = 0; level <= m_lods.size(); level++) {
+        std::shared_ptr<IndexedVertexData> indexed = std::dynamic_pointer_cast<IndexedVertexData>(
+            level == 0 ? m_vertex_data : m_lods[level - 1]);
+        if (indexed != nullptr) indexed->bake_lighting(model, i_lighting, i_occlusion, m_baked_lighting[level]);
+    }
+    m_baked_model = model;
+    m_baked_lights = &i_lighting;
+    m_baked_light_generation = i_lighting.get_directional_generation();
+}
+
+void SceneObject::clear_baked_lighting() {
+    m_baked_lighting.clear();
+    m_baked_lights = nullptr;
+}
+
+bool SceneObject::has_baked_lighting() {
+    return !m_baked_lighting.empty();
 }
 
 void SceneObject::set_transform(Transform i_tf) {
@@ -996,6 +1622,90 @@ void SceneObject::set_specular_strength(float i_specular_strength) {
     m_specular_strength = i_specular_strength;
 }
 
-Transform SceneObject::get_transform() {
+void SceneObject::set_draw_style(DrawStyle i_style) {
+    m_draw_style = i_style;
+}
+
+const DrawStyle& SceneObject::get_draw_style() const {
+    return m_draw_style;
+}
+
+const Transform& SceneObject::get_transform() const {
     return m_transform;
-}
\ No newline at end of file
+}
+
+std::shared_ptr<VertexData> SceneObject::get_vertex_data() {
+    return m_vertex_data;
+}
+
+InstancedSceneObject::InstancedSceneObject() {
+    m_vertex_data = nullptr;
+}
+
+InstancedSceneObject::InstancedSceneObject(std::shared_ptr<IndexedVertexData> i_vertex_data) {
+    m_vertex_data = i_vertex_data;
+}
+
+InstancedSceneObject::~InstancedSceneObject() {
+
+}
+
+void InstancedSceneObject::draw(const Camera& i_camera, PlaydateAPI* pd, RenderTarget& target,
+    Lighting& lighting) {
+    if (m_vertex_data == nullptr || m_transforms.empty()) return;
+
+    if (m_models_dirty) {
+        m_models.resize(m_transforms.size());
+        for (size_t i = 0; i < m_transforms.size(); i++) {
+            m_models[i] = transform_to_model(m_transforms[i]);
+        }
+        m_models_dirty = false;
+    }
+
+    glm::mat4 view = i_camera.GetViewMatrix();
+    glm::mat4 perspective = SceneObject::get_projection_matrix();
+    Frustum frustum;
+
+    glm::vec4 center = glm::vec4(m_vertex_data->get_bounds_center(), 1.0f);
+    float radius = m_vertex_data->get_bounds_radius();
+
+    /* Cull the whole batch by bounding sphere before touching any vertex */
+    m_visible_models.clear();
+    for (size_t i = 0; i < m_models.size(); i++) {
+        glm::vec3 view_center = glm::vec3(view * (m_models[i] * center));
+        if (frustum.sphere_visible(view_center, radius * transform_max_scale(m_transforms[i]))) {
+            m_visible_models.push_back(m_models[i]);
+        }
+    }
+    if (m_visible_models.empty()) return;
+
+    m_vertex_data->draw_instanced(pd, m_visible_models, view, perspective, target, lighting, m_draw_style);
+}
+
+int InstancedSceneObject::add_instance(Transform i_tf) {
+    m_transforms.push_back(i_tf);
+    m_models_dirty = true;
+    return m_transforms.size() - 1;
+}
+
+void InstancedSceneObject::set_instance_transform(int i_idx, Transform i_tf) {
+    m_transforms[i_idx] = i_tf;
+    m_models_dirty = true;
+}
+
+const Transform& InstancedSceneObject::get_instance_transform(int i_idx) const {
+    return m_transforms[i_idx];
+}
+
+void InstancedSceneObject::set_draw_style(DrawStyle i_style) {
+    m_draw_style = i_style;
+}
+
+int InstancedSceneObject::instance_count() {
+    return m_transforms.size();
+}
+
+void InstancedSceneObject::clear_instances() {
+    m_transforms.clear();
+    m_models_dirty = true;
+}
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory>
+#include <string.h>
 
 #include "pd_api.h"
 #include "pdcpp/pdnewlib.h"
@@ -20,9 +21,13 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "SceneObject.hpp"
-#include "WFObjLoader.hpp"
+#include "ImpostorCache.hpp"
+#include "OcclusionBuffer.hpp"
+#include "FramePresenter.hpp"
+#include "AssetLoader.hpp"
 #include "utils.hpp"
 #include "ScreenGlobals.hpp"
+#include "meshes/submarine.hpp"
 
 static int update(void* userdata);
 const char* fontpath = "/System/Fonts/Asheville-Sans-14-Bold.pft";
@@ -32,11 +37,20 @@ SceneObject submarineObj;
 SceneObject mapObj;
 Camera camera;
 std::vector<int> depth_buffer;
-std::vector<std::vector<int>> bayer_matrix;
+ImpostorCache impostor_cache;
+OcclusionBuffer occlusion_buffer;
+std::shared_ptr<MeshHandle> map_occluder;
+FramePresenter frame_presenter;
+AssetLoader asset_loader;
+Lighting lighting;
+// Where the submarine's lamp sits relative to it
+const glm::vec3 SUB_LAMP_OFFSET{0.0f, 3.0f, 2.0f};
+bool scene_ready = false;
 
 LCDBitmap* frame_buffer;
 uint8_t* fb_data;
 int rowbytes;
+RenderTarget screen_target;
 
 #ifdef __cplusplus
 extern "C" {
@@ -59,22 +73,47 @@ extern "C" {
 			if (font == NULL)
 				pd->system->error("%s:%i Couldn't load font %s: %s", __FILE__, __LINE__, fontpath, err);
 
-			WFObjLoader wf_obj_loader;
-
+			// Meshes are converted from Source/*.obj by tools/objconvert. The
+			// submarine is compiled in, the map is loaded a slice per frame
+			// by update()
 			//scene_object = (SceneObject*)malloc(sizeof(SceneObject));
 
-			submarineObj = wf_obj_loader.create_scene_object_from_file("submarine.obj", pd);
-			mapObj = wf_obj_loader.create_scene_object_from_file("map.obj", pd);
+			submarineObj = SceneObject(std::make_shared<IndexedVertexData>(SUBMARINE_MESH));
+			submarineObj.generate_lods(3);
+			mapObj.set_mesh_handle(asset_loader.load_mesh("map.mesh"));
+			map_occluder = asset_loader.load_mesh("map_occluder.mesh");
 
 			submarineObj.set_position(glm::vec3(0.0f, 0.0f, 0.0f));
 			mapObj.set_position(glm::vec3(0.0f, 0.0f, 0.0f));
+			// The map is low poly and meant to look faceted
+			DrawStyle map_style;
+			map_style.m_shading_mode = ShadingMode::Flat;
+			mapObj.set_draw_style(map_style);
+			// The submarine's shading is painted into Source/matcap.pgm
+			std::shared_ptr<Matcap> matcap = std::make_shared<Matcap>();
+			matcap->load(pd, "matcap.pgm");
+			DrawStyle sub_style;
+			sub_style.m_shading_mode = ShadingMode::Matcap;
+			sub_style.m_matcap = matcap;
+			submarineObj.set_draw_style(sub_style);
+
+			// Default daylight from above plus a lamp that follows the submarine
+			PointLight sub_lamp;
+			sub_lamp.m_light_color = glm::vec4(1.0f, 1.0f, 1.0f, 0.4f);
+			sub_lamp.m_ambientIntensity = 0.0f;
+			lighting.add_point_light(sub_lamp);
 			depth_buffer.resize(SCREEN_WIDTH * SCREEN_HEIGHT, -INFINITY);
-			bayer_matrix = bayerMatrix(512);
 
 			frame_buffer = pd->graphics->newBitmap(SCREEN_WIDTH, SCREEN_HEIGHT, kColorWhite);
 			int width, height;
 			pd->graphics->getBitmapData(frame_buffer, &width, &height, &rowbytes, NULL, &fb_data);
 
+			screen_target.m_data = fb_data;
+			screen_target.m_rowbytes = rowbytes;
+			screen_target.m_depth_buffer = depth_buffer.data();
+			screen_target.m_width = SCREEN_WIDTH;
+			screen_target.m_height = SCREEN_HEIGHT;
+
 			pd->system->setPeripheralsEnabled(kAccelerometer);
 
 			pd->display->setScale(PIXEL_SCALE);
@@ -211,6 +250,7 @@ void control_object(PlaydateAPI* pd, SceneObject* obj) {
 	glm::vec3 pos = obj->get_transform().m_position;
 	pos += glm::vec3(sub_velocity);
 	obj->set_position(pos);
+	lighting.set_point_light_position(0, pos + SUB_LAMP_OFFSET);
 
 
 
@@ -244,20 +284,63 @@ void control_object(PlaydateAPI* pd, SceneObject* obj) {
 
 glm::quat rotation_quat;
 
-static int update(void* userdata)
+static void draw_loading_screen(PlaydateAPI* pd, float progress)
 {
-	std::fill(depth_buffer.begin(), depth_buffer.end(), INT_MAX);
+	const int bar_width = 200;
+	const int bar_height = 10;
+	int bar_x = (SCREEN_WIDTH - bar_width) / 2;
+	int bar_y = SCREEN_HEIGHT / 2 + 10;
+
+	pd->graphics->clear(kColorWhite);
+	if (font != NULL) {
+		pd->graphics->setFont(font);
+	}
+	const char* text = "Loading";
+	pd->graphics->drawText(text, strlen(text), kASCIIEncoding, bar_x, bar_y - 24);
+	pd->graphics->drawRect(bar_x, bar_y, bar_width, bar_height, kColorBlack);
+	pd->graphics->fillRect(bar_x + 2, bar_y + 2, (int)((bar_width - 4) * progress), bar_height - 4, kColorBlack);
+}
 
+static int update(void* userdata)
+{
 	PlaydateAPI* pd = (PlaydateAPI*)userdata;
 
+	if (!scene_ready) {
+		if (asset_loader.update(pd)) {
+			draw_loading_screen(pd, asset_loader.get_progress());
+			return 1;
+		}
+		if (mapObj.is_loaded()) {
+			// A low poly hull just behind the map's walls, which hides
+			// whatever is outside the map
+			if (map_occluder->m_ready) {
+				mapObj.set_occluder(map_occluder->m_vertex_data);
+			}
+			// The map never moves and the daylight is fixed. Its faces are
+			// too large for per-vertex occlusion, so that is left out.
+			mapObj.bake_lighting(lighting);
+		}
+		scene_ready = true;
+	}
+
+	std::fill(depth_buffer.begin(), depth_buffer.end(), INT_MAX);
+
 	pd->graphics->clearBitmap(frame_buffer, kColorWhite);
 
 	control_object(pd, &submarineObj);
-	int* depth_data = depth_buffer.data();
-	submarineObj.draw(camera, pd, depth_data, bayer_matrix);
-	mapObj.draw(camera, pd, depth_data, bayer_matrix);
 
-	pd->graphics->drawBitmap(frame_buffer, 0, 0, kBitmapUnflipped);
+	// Objects are tested against the occluders before being drawn. The map
+	// isn't, its own hull sits behind it.
+	occlusion_buffer.clear();
+	occlusion_buffer.add_occluder(mapObj, camera);
+
+	impostor_cache.begin_frame();
+	if (!occlusion_buffer.is_occluded(submarineObj, camera)) {
+		impostor_cache.draw(submarineObj, camera, pd, screen_target, lighting);
+	}
+	mapObj.draw(camera, pd, screen_target, lighting);
+
+	frame_presenter.present(pd, frame_buffer);
 
 	pd->system->drawFPS(0, 0);
 
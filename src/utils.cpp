@@ -14,37 +14,10 @@ float clamp_to_screen_x(float f) {
     return fmaxf(0, fminf(f, SCREEN_WIDTH - 1));
 }
 
-std::vector<std::vector<int>> bayerMatrix(int n) {
-    std::vector<std::vector<int>> B = {{0, 2}, {3, 1}};
-    int size = 2;
-
-    while (size < n) {
-        std::vector<std::vector<int>> newB(size * 2, std::vector<int>(size * 2));
-        for (int y = 0; y < size; ++y) {
-            for (int x = 0; x < size; ++x) {
-                int v = B[y][x];
-                newB[y][x] = 4 * v;
-                newB[y][x + size] = 4 * v + 2;
-                newB[y + size][x] = 4 * v + 3;
-                newB[y + size][x + size] = 4 * v + 1;
-            }
-        }
-        B = std::move(newB);
-        size *= 2;
-    }
-
-    // Normalize to [0,1)
-    std::vector<std::vector<float>> normalized(n, std::vector<float>(n));
-    for (int y = 0; y < n; ++y) {
-        for (int x = 0; x < n; ++x) {
-            normalized[y][x] = B[y][x] / float(n * n);
-        }
+uint32_t fnv1a_hash(const void* i_data, size_t i_size, uint32_t i_hash) {
+    const uint8_t* bytes = (const uint8_t*)i_data;
+    for (size_t i = 0; i < i_size; i++) {
+        i_hash = (i_hash ^ bytes[i]) * 16777619u;
     }
-    std::vector<std::vector<int>> int_normalized(n, std::vector<int>(n));
-    for (int y = 0; y < n; ++y) {
-        for (int x = 0; x < n; ++x) {
-            int_normalized[y][x] = normalized[y][x] * 255;
-        }
-    }
-    return int_normalized;
-}
\ No newline at end of file
+    return i_hash;
+}
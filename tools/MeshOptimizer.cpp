@@ -0,0 +1,118 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+
+void optimize_triangle_order(
+    std::vector<uint16_t>& io_indices,
+    std::vector<uint16_t>& io_normal_indices,
+    int i_vertex_count,
+    int i_cache_size
+) {
+    int triangle_count = io_indices.size() / 3;
+    if (triangle_count == 0) return;
+
+    /* Vertex -> triangles adjacency in one flat array */
+    std::vector<int> live(i_vertex_count, 0);
+    for (uint16_t index : io_indices) live[index]++;
+    std::vector<int> offsets(i_vertex_count + 1, 0);
+    for (int v = 0; v < i_vertex_count; v++) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<int> adjacency(offsets[i_vertex_count]);
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (int t = 0; t < triangle_count; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[io_indices[t * 3 + k]]++] = t;
+        }
+    }
+
+    std::vector<int> cache_time(i_vertex_count, 0);
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<int> dead_end;
+    std::vector<int> candidates;
+    std::vector<int> order;
+    order.reserve(triangle_count);
+
+    int time = i_cache_size + 1;
+    int cursor = 0;
+    int fanning = 0;
+    while (fanning >= 0) {
+        candidates.clear();
+        for (int a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            int t = adjacency[a];
+            if (emitted[t]) continue;
+            emitted[t] = true;
+            order.push_back(t);
+            for (int k = 0; k < 3; k++) {
+                int v = io_indices[t * 3 + k];
+                dead_end.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cache_time[v] > i_cache_size) {
+                    cache_time[v] = time++;
+                }
+            }
+        }
+
+        /* Prefer the candidate that will still be in cache after its
+           remaining triangles are emitted, oldest first */
+        int next = -1;
+        int best = -1;
+        for (int v : candidates) {
+            if (live[v] <= 0) continue;
+            int priority = 0;
+            if (time - cache_time[v] + 2 * live[v] <= i_cache_size) {
+                priority = time - cache_time[v];
+            }
+            if (priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+        while (next < 0 && !dead_end.empty()) {
+            int v = dead_end.back();
+            dead_end.pop_back();
+            if (live[v] > 0) next = v;
+        }
+        while (next < 0 && cursor < i_vertex_count) {
+            if (live[cursor] > 0) next = cursor;
+            cursor++;
+        }
+        fanning = next;
+    }
+
+    std::vector<uint16_t> indices(io_indices.size());
+    std::vector<uint16_t> normal_indices(io_normal_indices.size());
+    for (int i = 0; i < triangle_count; i++) {
+        for (int k = 0; k < 3; k++) {
+            indices[i * 3 + k] = io_indices[order[i] * 3 + k];
+            normal_indices[i * 3 + k] = io_normal_indices[order[i] * 3 + k];
+        }
+    }
+    io_indices.swap(indices);
+    io_normal_indices.swap(normal_indices);
+}
+
+std::vector<int> order_by_first_use(std::vector<uint16_t>& io_indices, int i_element_count) {
+    std::vector<int> remap(i_element_count, -1);
+    int next = 0;
+    for (uint16_t& index : io_indices) {
+        if (remap[index] < 0) remap[index] = next++;
+        index = remap[index];
+    }
+    for (int& slot : remap) {
+        if (slot < 0) slot = next++;
+    }
+    return remap;
+}
+
+float average_cache_miss_ratio(const std::vector<uint16_t>& i_indices, int i_cache_size) {
+    if (i_indices.size() < 3) return 0.0f;
+    std::vector<int> fifo(i_cache_size, -1);
+    int head = 0;
+    int misses = 0;
+    for (uint16_t index : i_indices) {
+        if (std::find(fifo.begin(), fifo.end(), (int)index) != fifo.end()) continue;
+        fifo[head] = index;
+        head = (head + 1) % i_cache_size;
+        misses++;
+    }
+    return (float)misses / (i_indices.size() / 3);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Offline index optimizations for objconvert. All functions work on
+// triangle lists.
+
+// Reorders triangles for post-transform cache locality using Tipsify
+// (Sander, Nehab and Barczak 2007), tuned for a FIFO of i_cache_size.
+// i_normal_indices is permuted alongside i_indices.
+void optimize_triangle_order(
+    std::vector<uint16_t>& io_indices,
+    std::vector<uint16_t>& io_normal_indices,
+    int i_vertex_count,
+    int i_cache_size);
+
+// Renumbers an index stream so elements appear in order of first use,
+// returns old index -> new index. Elements never referenced keep their
+// relative order at the end.
+std::vector<int> order_by_first_use(std::vector<uint16_t>& io_indices, int i_element_count);
+
+// Average cache miss ratio, transforms per triangle with a FIFO cache of
+// i_cache_size entries. 0.5 is ideal for a regular grid, 3 is worst case.
+float average_cache_miss_ratio(const std::vector<uint16_t>& i_indices, int i_cache_size);
@@ -0,0 +1,92 @@
+// Times the game's update() on the host. The game is started in <data dir>
+// (Source/), updated until the map has loaded, then timed over a number of
+// frames with no input. --smooth draws the map with smooth instead of flat
+// shading. Host times only compare builds and settings with each other,
+// they say little about the device.
+//
+//   frame_bench <data dir> [frames] [--smooth] [--pbm <file.pbm>]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include "SceneObject.hpp"
+#include "HostPlaydate.hpp"
+
+extern "C" int eventHandler(PlaydateAPI* pd, PDSystemEvent event, uint32_t arg);
+
+/* pdnewlib hooks newlib up to the device's allocator, the host has its own */
+extern "C" int eventHandler_pdnewlib(PlaydateAPI*, PDSystemEvent, uint32_t) {
+    return 0;
+}
+
+/* Defined in src/main.cpp */
+extern SceneObject mapObj;
+
+static const int MAX_LOADING_FRAMES = 10000;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <data dir> [frames] [--smooth] [--pbm <file.pbm>]\n", argv[0]);
+        return 2;
+    }
+    int frames = 100;
+    bool smooth = false;
+    const char* pbm_path = nullptr;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--smooth") == 0) {
+            smooth = true;
+        } else if (strcmp(argv[i], "--pbm") == 0 && i + 1 < argc) {
+            pbm_path = argv[++i];
+        } else {
+            frames = atoi(argv[i]);
+        }
+    }
+    if (frames <= 0 || chdir(argv[1]) != 0) {
+        fprintf(stderr, "usage: %s <data dir> [frames] [--smooth] [--pbm <file.pbm>]\n", argv[0]);
+        return 2;
+    }
+
+    PlaydateAPI* pd = get_host_playdate_api();
+    eventHandler(pd, kEventInit, 0);
+    PDCallbackFunction* update = get_host_update_callback();
+    if (update == nullptr) {
+        fprintf(stderr, "the game set no update callback\n");
+        return 1;
+    }
+    if (smooth) {
+        DrawStyle style = mapObj.get_draw_style();
+        style.m_shading_mode = ShadingMode::Smooth;
+        mapObj.set_draw_style(style);
+    }
+
+    /* Loading screen frames, then the one that finishes setting up the scene */
+    int loading_frames = 0;
+    while (!mapObj.is_loaded() && loading_frames < MAX_LOADING_FRAMES) {
+        update(get_host_update_userdata());
+        loading_frames++;
+    }
+    if (!mapObj.is_loaded() || get_host_error_count() > 0) {
+        fprintf(stderr, "the map didn't load from %s\n", argv[1]);
+        return 1;
+    }
+    update(get_host_update_userdata());
+
+    reset_host_rows_marked();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        update(get_host_update_userdata());
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count();
+
+    printf("%s map: %d loading frames, %d frames, %.3f ms/frame, %.1f rows pushed/frame\n",
+        smooth ? "smooth" : "flat", loading_frames, frames, ms / frames,
+        get_host_rows_marked() / (double)frames);
+    if (pbm_path != nullptr && !write_host_frame_pbm(pbm_path)) {
+        fprintf(stderr, "can't write %s\n", pbm_path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Times drawing copies of the submarine as separate SceneObjects against
+// one InstancedSceneObject, into a screen sized target. The copies sit in
+// a grid eight wide in front of the camera. Up to about 64 are all on
+// screen, more run off its top and bottom, where the batch culls them
+// before any vertex work. Host times only compare the two paths with each
+// other, they say little about the device.
+//
+//   instancing_bench [copies] [frames]
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <glm/gtc/quaternion.hpp>
+#include "SceneObject.hpp"
+#include "HostPlaydate.hpp"
+#include "ScreenGlobals.hpp"
+#include "meshes/submarine.hpp"
+
+static const int GRID_COLUMNS = 8;
+
+struct BenchTarget {
+    std::vector<uint8_t> m_data;
+    std::vector<int> m_depth;
+    RenderTarget m_target;
+
+    BenchTarget() {
+        int rowbytes = ((SCREEN_WIDTH + 31) / 32) * 4;
+        m_data.resize(rowbytes * SCREEN_HEIGHT);
+        m_depth.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+        m_target.m_data = m_data.data();
+        m_target.m_rowbytes = rowbytes;
+        m_target.m_depth_buffer = m_depth.data();
+        m_target.m_width = SCREEN_WIDTH;
+        m_target.m_height = SCREEN_HEIGHT;
+    }
+
+    void clear() {
+        std::fill(m_data.begin(), m_data.end(), 0xFF);
+        std::fill(m_depth.begin(), m_depth.end(), INT_MAX);
+    }
+};
+
+template<typename DrawFrame>
+static double time_frames(BenchTarget& io_target, int i_frames, DrawFrame i_draw) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < i_frames; i++) {
+        io_target.clear();
+        i_draw();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / i_frames;
+}
+
+int main(int argc, char** argv) {
+    int copies = argc > 1 ? atoi(argv[1]) : 64;
+    int frames = argc > 2 ? atoi(argv[2]) : 200;
+    if (copies <= 0 || frames <= 0) {
+        fprintf(stderr, "usage: %s [copies] [frames]\n", argv[0]);
+        return 2;
+    }
+    PlaydateAPI* pd = get_host_playdate_api();
+    Camera camera;
+    Lighting lighting;
+    lighting.set_ambient(0.2f);
+
+    std::shared_ptr<IndexedVertexData> mesh = std::make_shared<IndexedVertexData>(SUBMARINE_MESH);
+    int rows = (copies + GRID_COLUMNS - 1) / GRID_COLUMNS;
+    std::vector<SceneObject> objects;
+    InstancedSceneObject instanced(mesh);
+    for (int i = 0; i < copies; i++) {
+        Transform tf;
+        int column = i % GRID_COLUMNS;
+        int row = i / GRID_COLUMNS;
+        tf.m_position = glm::vec3((column - (GRID_COLUMNS - 1) * 0.5f) * 2.5f,
+            (row - (rows - 1) * 0.5f) * 2.0f, -25.0f);
+        tf.m_rotation = glm::angleAxis(glm::radians(15.0f * i), glm::vec3(0.0f, 1.0f, 0.0f));
+        tf.m_scale = glm::vec3(0.5f);
+        objects.emplace_back(mesh);
+        objects.back().set_transform(tf);
+        instanced.add_instance(tf);
+    }
+
+    BenchTarget target;
+    double separate_ms = time_frames(target, frames, [&]() {
+        for (SceneObject& object : objects) {
+            object.draw(camera, pd, target.m_target, lighting);
+        }
+    });
+    double instanced_ms = time_frames(target, frames, [&]() {
+        instanced.draw(camera, pd, target.m_target, lighting);
+    });
+
+    printf("%d copies of %d triangles over %d frames: separate %.3f ms/frame, instanced %.3f ms/frame\n",
+        copies, mesh->triangle_count(), frames, separate_ms, instanced_ms);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Times WFObjLoader on the host: each file is loaded in one go, without
+// LODs, a number of times, and the fastest and mean load are printed with
+// a hash of the buffers it built, so a faster parser can be checked to
+// build the same mesh. Host times only compare builds with each other,
+// they say little about the device.
+//
+//   obj_load_bench [-n <runs>] <file.obj>...
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "WFObjLoader.hpp"
+#include "HostPlaydate.hpp"
+
+/* FNV-1a over the bits of every buffer the mesh is drawn from */
+static uint64_t hash_mesh(IndexedVertexData& i_mesh) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](uint32_t i_value) {
+        hash = (hash ^ i_value) * 1099511628211ull;
+    };
+    for (float f : i_mesh.get_vertex_buffer()) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        add(bits);
+    }
+    for (int i : i_mesh.get_index_buffer()) {
+        add((uint32_t)i);
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    int runs = 20;
+    int first_file = 1;
+    if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+        runs = atoi(argv[2]);
+        first_file = 3;
+    }
+    if (first_file >= argc || runs <= 0) {
+        fprintf(stderr, "usage: %s [-n <runs>] <file.obj>...\n", argv[0]);
+        return 2;
+    }
+    PlaydateAPI* pd = get_host_playdate_api();
+
+    for (int file = first_file; file < argc; file++) {
+        double best_ms = 0.0;
+        double total_ms = 0.0;
+        std::shared_ptr<IndexedVertexData> mesh;
+        for (int run = 0; run < runs; run++) {
+            auto start = std::chrono::steady_clock::now();
+            WFObjLoader loader;
+            SceneObject object = loader.create_scene_object_from_file(argv[file], pd);
+            auto end = std::chrono::steady_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            best_ms = run == 0 ? ms : std::min(best_ms, ms);
+            total_ms += ms;
+            mesh = std::dynamic_pointer_cast<IndexedVertexData>(object.get_vertex_data());
+        }
+        if (mesh == nullptr || get_host_error_count() > 0) {
+            fprintf(stderr, "%s didn't load\n", argv[file]);
+            return 1;
+        }
+        printf("%s: %d triangles, hash %016llx, best %.2f ms, mean %.2f ms over %d runs\n",
+            argv[file], mesh->triangle_count(), (unsigned long long)hash_mesh(*mesh),
+            best_ms, total_ms / runs, runs);
+    }
+    return 0;
+}
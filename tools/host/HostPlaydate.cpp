@@ -0,0 +1,284 @@
+#include "HostPlaydate.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+struct LCDBitmap {
+    int m_width;
+    int m_height;
+    int m_rowbytes;
+    std::vector<uint8_t> m_data;
+};
+
+struct LCDFont {
+    int m_unused;
+};
+
+static uint8_t s_frame[LCD_ROWSIZE * LCD_ROWS];
+static int s_rows_marked = 0;
+static int s_error_count = 0;
+static int s_read_count = 0;
+static float s_crank_angle = 0.0f;
+static PDButtons s_buttons = (PDButtons)0;
+static PDCallbackFunction* s_update = nullptr;
+static void* s_update_userdata = nullptr;
+static LCDFont s_font;
+static const auto s_start_time = std::chrono::steady_clock::now();
+
+/* System */
+
+static void* sys_realloc(void* ptr, size_t size) {
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    return realloc(ptr, size);
+}
+
+static void sys_log(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static void sys_error(const char* fmt, ...) {
+    s_error_count++;
+    fputs("error: ", stderr);
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+static void sys_set_update_callback(PDCallbackFunction* update, void* userdata) {
+    s_update = update;
+    s_update_userdata = userdata;
+}
+
+static void sys_get_button_state(PDButtons* current, PDButtons* pushed, PDButtons* released) {
+    if (current != nullptr) *current = s_buttons;
+    if (pushed != nullptr) *pushed = (PDButtons)0;
+    if (released != nullptr) *released = (PDButtons)0;
+}
+
+static void sys_set_peripherals_enabled(PDPeripherals) {}
+
+static void sys_get_accelerometer(float* x, float* y, float* z) {
+    /* Lying flat */
+    *x = 0.0f;
+    *y = 0.0f;
+    *z = 1.0f;
+}
+
+static float sys_get_crank_angle() {
+    return s_crank_angle;
+}
+
+static void sys_draw_fps(int, int) {}
+
+static unsigned int sys_get_current_time_milliseconds() {
+    return (unsigned int)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - s_start_time).count();
+}
+
+static const playdate_sys s_system = {
+    sys_realloc, sys_log, sys_error, sys_set_update_callback, sys_get_button_state,
+    sys_set_peripherals_enabled, sys_get_accelerometer, sys_get_crank_angle, sys_draw_fps,
+    sys_get_current_time_milliseconds
+};
+
+/* Files */
+
+static SDFile* file_open(const char* name, FileOptions mode) {
+    return (SDFile*)fopen(name, (mode & (kFileWrite | kFileAppend)) ? "wb" : "rb");
+}
+
+static int file_close(SDFile* file) {
+    return fclose((FILE*)file);
+}
+
+static int file_read(SDFile* file, void* buf, unsigned int len) {
+    s_read_count++;
+    return (int)fread(buf, 1, len, (FILE*)file);
+}
+
+static int file_write(SDFile* file, const void* buf, unsigned int len) {
+    return (int)fwrite(buf, 1, len, (FILE*)file);
+}
+
+static int file_seek(SDFile* file, int pos, int whence) {
+    return fseek((FILE*)file, pos, whence);
+}
+
+static int file_tell(SDFile* file) {
+    return (int)ftell((FILE*)file);
+}
+
+static int file_stat(const char* path, FileStat* stat) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return -1;
+    fseek(file, 0, SEEK_END);
+    memset(stat, 0, sizeof(*stat));
+    stat->size = (unsigned int)ftell(file);
+    fclose(file);
+    return 0;
+}
+
+static const char* file_geterr() {
+    return strerror(errno);
+}
+
+static const playdate_file s_file = {
+    file_open, file_close, file_read, file_write, file_seek, file_tell, file_stat, file_geterr
+};
+
+/* Graphics, bitmaps are stored like the device's: a set bit is white */
+
+static void frame_set_pixel(int x, int y, LCDColor color) {
+    if (x < 0 || y < 0 || x >= LCD_COLUMNS || y >= LCD_ROWS) return;
+    uint8_t bit = 0x80 >> (x & 7);
+    uint8_t& byte = s_frame[y * LCD_ROWSIZE + x / 8];
+    byte = color == kColorWhite ? (byte | bit) : (byte & ~bit);
+}
+
+static LCDFont* gfx_load_font(const char*, const char**) {
+    return &s_font;
+}
+
+static LCDBitmap* gfx_new_bitmap(int width, int height, LCDColor bgcolor) {
+    int rowbytes = ((width + 31) / 32) * 4;
+    LCDBitmap* bitmap = new LCDBitmap{width, height, rowbytes, {}};
+    bitmap->m_data.assign(rowbytes * height, bgcolor == kColorWhite ? 0xFF : 0x00);
+    return bitmap;
+}
+
+static void gfx_free_bitmap(LCDBitmap* bitmap) {
+    delete bitmap;
+}
+
+static void gfx_get_bitmap_data(LCDBitmap* bitmap, int* width, int* height, int* rowbytes,
+    uint8_t** mask, uint8_t** data) {
+    if (width != nullptr) *width = bitmap->m_width;
+    if (height != nullptr) *height = bitmap->m_height;
+    if (rowbytes != nullptr) *rowbytes = bitmap->m_rowbytes;
+    if (mask != nullptr) *mask = nullptr;
+    if (data != nullptr) *data = bitmap->m_data.data();
+}
+
+static void gfx_clear_bitmap(LCDBitmap* bitmap, LCDColor bgcolor) {
+    std::fill(bitmap->m_data.begin(), bitmap->m_data.end(), bgcolor == kColorWhite ? 0xFF : 0x00);
+}
+
+static void gfx_draw_bitmap(LCDBitmap* bitmap, int x, int y, LCDBitmapFlip) {
+    for (int row = 0; row < bitmap->m_height; row++) {
+        for (int col = 0; col < bitmap->m_width; col++) {
+            bool white = bitmap->m_data[row * bitmap->m_rowbytes + col / 8] & (0x80 >> (col & 7));
+            frame_set_pixel(x + col, y + row, white ? kColorWhite : kColorBlack);
+        }
+    }
+    s_rows_marked += bitmap->m_height;
+}
+
+static uint8_t* gfx_get_frame() {
+    return s_frame;
+}
+
+static void gfx_mark_updated_rows(int start, int end) {
+    s_rows_marked += end - start + 1;
+}
+
+static void gfx_clear(LCDColor color) {
+    memset(s_frame, color == kColorWhite ? 0xFF : 0x00, sizeof(s_frame));
+}
+
+static void gfx_fill_rect(int x, int y, int width, int height, LCDColor color) {
+    for (int row = y; row < y + height; row++) {
+        for (int col = x; col < x + width; col++) {
+            frame_set_pixel(col, row, color);
+        }
+    }
+}
+
+static void gfx_draw_rect(int x, int y, int width, int height, LCDColor color) {
+    for (int col = x; col < x + width; col++) {
+        frame_set_pixel(col, y, color);
+        frame_set_pixel(col, y + height - 1, color);
+    }
+    for (int row = y; row < y + height; row++) {
+        frame_set_pixel(x, row, color);
+        frame_set_pixel(x + width - 1, row, color);
+    }
+}
+
+static int gfx_draw_text(const void*, size_t, PDStringEncoding, int, int) {
+    return 0;
+}
+
+static void gfx_set_font(LCDFont*) {}
+
+static const playdate_graphics s_graphics = {
+    gfx_load_font, gfx_new_bitmap, gfx_free_bitmap, gfx_get_bitmap_data, gfx_clear_bitmap,
+    gfx_draw_bitmap, gfx_get_frame, gfx_mark_updated_rows, gfx_clear, gfx_fill_rect,
+    gfx_draw_rect, gfx_draw_text, gfx_set_font
+};
+
+static void display_set_scale(unsigned int) {}
+
+static const playdate_display s_display = { display_set_scale };
+
+static PlaydateAPI s_api = { &s_system, &s_file, &s_graphics, &s_display };
+
+PlaydateAPI* get_host_playdate_api() {
+    return &s_api;
+}
+
+int get_host_error_count() {
+    return s_error_count;
+}
+
+int get_host_read_count() {
+    return s_read_count;
+}
+
+void set_host_crank_angle(float i_degrees) {
+    s_crank_angle = i_degrees;
+}
+
+void set_host_buttons(PDButtons i_buttons) {
+    s_buttons = i_buttons;
+}
+
+PDCallbackFunction* get_host_update_callback() {
+    return s_update;
+}
+
+void* get_host_update_userdata() {
+    return s_update_userdata;
+}
+
+int get_host_rows_marked() {
+    return s_rows_marked;
+}
+
+void reset_host_rows_marked() {
+    s_rows_marked = 0;
+}
+
+bool write_host_frame_pbm(const char* i_filepath) {
+    FILE* file = fopen(i_filepath, "wb");
+    if (file == nullptr) return false;
+    fprintf(file, "P4\n%d %d\n", LCD_COLUMNS, LCD_ROWS);
+    for (int y = 0; y < LCD_ROWS; y++) {
+        for (int x = 0; x < LCD_COLUMNS / 8; x++) {
+            uint8_t black = ~s_frame[y * LCD_ROWSIZE + x];
+            fwrite(&black, 1, 1, file);
+        }
+    }
+    fclose(file);
+    return true;
+}
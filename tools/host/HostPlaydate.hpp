@@ -0,0 +1,30 @@
+#pragma once
+
+#include "pd_api.h"
+
+// Host implementation of the PlaydateAPI subset in pd_api.h. Files are
+// read with stdio, relative to the working directory. The display is a
+// 1-bit frame the size of the Playdate's. Errors are logged and counted
+// rather than halting, so tests can check that a bad file is rejected.
+PlaydateAPI* get_host_playdate_api();
+
+// Number of pd->system->error calls so far
+int get_host_error_count();
+// Number of pd->file->read calls so far
+int get_host_read_count();
+
+// Input seen by the game from the next update on
+void set_host_crank_angle(float i_degrees);
+void set_host_buttons(PDButtons i_buttons);
+
+// The game's update callback, once it has set one
+PDCallbackFunction* get_host_update_callback();
+void* get_host_update_userdata();
+
+// Rows handed to markUpdatedRows or covered by drawBitmap since the last
+// reset
+int get_host_rows_marked();
+void reset_host_rows_marked();
+
+// Write the display to a binary PBM, black pixels set
+bool write_host_frame_pbm(const char* i_filepath);
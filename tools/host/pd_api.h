@@ -0,0 +1,102 @@
+#pragma once
+
+// Stand-in for the Playdate SDK's pd_api.h, so game code can be built and
+// run on the host by the tests and benchmarks in tools/. It declares only
+// what the game uses, with the SDK's names; HostPlaydate.cpp implements it.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LCD_COLUMNS 400
+#define LCD_ROWS 240
+#define LCD_ROWSIZE 52
+
+typedef struct LCDBitmap LCDBitmap;
+typedef struct LCDFont LCDFont;
+typedef struct SDFile SDFile;
+
+typedef enum { kColorBlack, kColorWhite, kColorClear, kColorXOR } LCDSolidColor;
+typedef uintptr_t LCDColor;
+typedef enum { kBitmapUnflipped, kBitmapFlippedX, kBitmapFlippedY, kBitmapFlippedXY } LCDBitmapFlip;
+typedef enum { kFileRead = 1, kFileReadData = 2, kFileWrite = 4, kFileAppend = 8 } FileOptions;
+typedef enum {
+    kButtonLeft = 1, kButtonRight = 2, kButtonUp = 4, kButtonDown = 8, kButtonB = 16, kButtonA = 32
+} PDButtons;
+typedef enum { kNone = 0, kAccelerometer = 1 } PDPeripherals;
+typedef enum {
+    kEventInit, kEventInitLua, kEventLock, kEventUnlock, kEventPause, kEventResume,
+    kEventTerminate, kEventKeyPressed, kEventKeyReleased, kEventLowPower
+} PDSystemEvent;
+typedef enum { kASCIIEncoding, kUTF8Encoding, k16BitLEEncoding } PDStringEncoding;
+typedef int PDCallbackFunction(void* userdata);
+
+typedef struct {
+    int isdir;
+    unsigned int size;
+    int m_year, m_month, m_day, m_hour, m_minute, m_second;
+} FileStat;
+
+struct playdate_sys {
+    void* (*realloc)(void* ptr, size_t size);
+    void (*logToConsole)(const char* fmt, ...);
+    void (*error)(const char* fmt, ...);
+    void (*setUpdateCallback)(PDCallbackFunction* update, void* userdata);
+    void (*getButtonState)(PDButtons* current, PDButtons* pushed, PDButtons* released);
+    void (*setPeripheralsEnabled)(PDPeripherals mask);
+    void (*getAccelerometer)(float* outx, float* outy, float* outz);
+    float (*getCrankAngle)(void);
+    void (*drawFPS)(int x, int y);
+    unsigned int (*getCurrentTimeMilliseconds)(void);
+};
+
+struct playdate_file {
+    SDFile* (*open)(const char* name, FileOptions mode);
+    int (*close)(SDFile* file);
+    int (*read)(SDFile* file, void* buf, unsigned int len);
+    int (*write)(SDFile* file, const void* buf, unsigned int len);
+    int (*seek)(SDFile* file, int pos, int whence);
+    int (*tell)(SDFile* file);
+    int (*stat)(const char* path, FileStat* stat);
+    const char* (*geterr)(void);
+};
+
+struct playdate_graphics {
+    LCDFont* (*loadFont)(const char* path, const char** outErr);
+    LCDBitmap* (*newBitmap)(int width, int height, LCDColor bgcolor);
+    void (*freeBitmap)(LCDBitmap* bitmap);
+    void (*getBitmapData)(LCDBitmap* bitmap, int* width, int* height, int* rowbytes, uint8_t** mask, uint8_t** data);
+    void (*clearBitmap)(LCDBitmap* bitmap, LCDColor bgcolor);
+    void (*drawBitmap)(LCDBitmap* bitmap, int x, int y, LCDBitmapFlip flip);
+    uint8_t* (*getFrame)(void);
+    void (*markUpdatedRows)(int start, int end);
+    void (*clear)(LCDColor color);
+    void (*fillRect)(int x, int y, int width, int height, LCDColor color);
+    void (*drawRect)(int x, int y, int width, int height, LCDColor color);
+    int (*drawText)(const void* text, size_t len, PDStringEncoding encoding, int x, int y);
+    void (*setFont)(LCDFont* font);
+};
+
+struct playdate_display {
+    void (*setScale)(unsigned int scale);
+};
+
+typedef struct PlaydateAPI {
+    const struct playdate_sys* system;
+    const struct playdate_file* file;
+    const struct playdate_graphics* graphics;
+    const struct playdate_display* display;
+} PlaydateAPI;
+
+#ifdef __cplusplus
+}
+#endif
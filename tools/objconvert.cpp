@@ -0,0 +1,482 @@
+// objconvert: converts a Wavefront OBJ into the binary mesh format read by
+// BinaryMeshLoader (see include/MeshFormat.hpp), or into a C++ header of
+// constexpr arrays wrapped by an EmbeddedMesh (see include/EmbeddedMesh.hpp)
+// when the output ends in .hpp.
+//
+//   objconvert <input.obj> <output.mesh|output.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <glm/glm.hpp>
+#include "MeshFormat.hpp"
+#include "Dither.hpp"
+#include "MeshOptimizer.hpp"
+
+// FIFO size triangles are ordered for and the cache miss ratio is reported at
+static const int VERTEX_CACHE_SIZE = 16;
+
+struct ObjMaterial {
+    std::string m_name;
+    // Defaults reproduce the game's identity material
+    glm::vec3 m_ambient{0.0f};
+    glm::vec3 m_diffuse{1.0f};
+    glm::vec3 m_specular{0.0f};
+    float m_shininess = 0.0f;
+    DitherKernel m_dither_kernel = DitherKernel::Bayer8;
+};
+
+struct ObjMesh {
+    std::vector<glm::vec3> m_positions;
+    std::vector<glm::vec3> m_normals;
+    // Triangulated corners, indices into m_positions / m_normals
+    std::vector<int> m_indices;
+    std::vector<int> m_normal_indices;
+    // m_materials[0] is the default for faces before any usemtl
+    std::vector<ObjMaterial> m_materials{ObjMaterial{}};
+    std::vector<int> m_triangle_materials;
+};
+
+static std::string directory_of(const char* i_path) {
+    std::string path = i_path;
+    size_t slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+}
+
+static void parse_mtl(const std::string& i_path, ObjMesh& o_mesh) {
+    std::ifstream file(i_path);
+    if (!file.is_open()) {
+        fprintf(stderr, "objconvert: no material library %s, using the default material\n", i_path.c_str());
+        return;
+    }
+
+    std::string line;
+    ObjMaterial* material = nullptr;
+    while (std::getline(file, line)) {
+        std::istringstream tokens(line);
+        std::string key;
+        tokens >> key;
+        if (key == "newmtl") {
+            o_mesh.m_materials.emplace_back();
+            material = &o_mesh.m_materials.back();
+            tokens >> material->m_name;
+        } else if (material == nullptr) {
+            continue;
+        } else if (key == "Ka") {
+            tokens >> material->m_ambient.x >> material->m_ambient.y >> material->m_ambient.z;
+        } else if (key == "Kd") {
+            tokens >> material->m_diffuse.x >> material->m_diffuse.y >> material->m_diffuse.z;
+        } else if (key == "Ks") {
+            tokens >> material->m_specular.x >> material->m_specular.y >> material->m_specular.z;
+        } else if (key == "Ns") {
+            tokens >> material->m_shininess;
+        } else if (key == "dither") {
+            std::string kernel;
+            tokens >> kernel;
+            if (!parse_dither_kernel(kernel, material->m_dither_kernel)) {
+                fprintf(stderr, "objconvert: unknown dither kernel %s in %s\n", kernel.c_str(), i_path.c_str());
+            }
+        }
+    }
+}
+
+static int find_material(const ObjMesh& i_mesh, const std::string& i_name) {
+    for (size_t i = 1; i < i_mesh.m_materials.size(); i++) {
+        if (i_mesh.m_materials[i].m_name == i_name) return i;
+    }
+    return 0;
+}
+
+static int resolve_index(long i_index, size_t i_count) {
+    /* OBJ indices are 1-based, negative ones count back from the end */
+    return i_index < 0 ? (int)(i_count + i_index) : (int)(i_index - 1);
+}
+
+static bool parse_obj(const char* i_path, ObjMesh& o_mesh) {
+    std::ifstream file(i_path);
+    if (!file.is_open()) {
+        fprintf(stderr, "objconvert: can't open %s\n", i_path);
+        return false;
+    }
+
+    std::string line;
+    std::vector<std::pair<int, int>> face;
+    int current_material = 0;
+    while (std::getline(file, line)) {
+        const char* p = line.c_str();
+        if (strncmp(p, "mtllib ", 7) == 0 || strncmp(p, "usemtl ", 7) == 0) {
+            std::istringstream tokens(line.substr(7));
+            std::string name;
+            tokens >> name;
+            if (p[0] == 'm') {
+                parse_mtl(directory_of(i_path) + name, o_mesh);
+            } else {
+                current_material = find_material(o_mesh, name);
+            }
+        } else if (p[0] == 'v' && p[1] == ' ') {
+            glm::vec3 v;
+            v.x = strtof(p + 2, (char**)&p);
+            v.y = strtof(p, (char**)&p);
+            v.z = strtof(p, (char**)&p);
+            o_mesh.m_positions.push_back(v);
+        } else if (p[0] == 'v' && p[1] == 'n' && p[2] == ' ') {
+            glm::vec3 n;
+            n.x = strtof(p + 3, (char**)&p);
+            n.y = strtof(p, (char**)&p);
+            n.z = strtof(p, (char**)&p);
+            o_mesh.m_normals.push_back(n);
+        } else if (p[0] == 'f' && p[1] == ' ') {
+            face.clear();
+            p += 2;
+            while (*p) {
+                while (*p == ' ' || *p == '\t' || *p == '\r') p++;
+                if (!*p) break;
+                char* end;
+                long v = strtol(p, &end, 10);
+                if (end == p) break;
+                p = end;
+                int vn = -1;
+                if (*p == '/') {
+                    p++;
+                    if (*p != '/') strtol(p, (char**)&p, 10);
+                    if (*p == '/') {
+                        p++;
+                        vn = resolve_index(strtol(p, (char**)&p, 10), o_mesh.m_normals.size());
+                    }
+                }
+                while (*p && *p != ' ' && *p != '\t') p++;
+                face.emplace_back(resolve_index(v, o_mesh.m_positions.size()), vn);
+            }
+
+            /* Faces without normals get their flat face normal */
+            if (face.size() >= 3 && face[0].second < 0) {
+                glm::vec3 a = o_mesh.m_positions[face[0].first];
+                glm::vec3 n = glm::cross(
+                    o_mesh.m_positions[face[1].first] - a, o_mesh.m_positions[face[2].first] - a);
+                o_mesh.m_normals.push_back(n);
+                for (auto& corner : face) corner.second = o_mesh.m_normals.size() - 1;
+            }
+
+            /* Fan triangulation */
+            for (size_t i = 1; i + 1 < face.size(); i++) {
+                std::pair<int, int> corners[3] = { face[0], face[i], face[i + 1] };
+                for (auto& corner : corners) {
+                    o_mesh.m_indices.push_back(corner.first);
+                    o_mesh.m_normal_indices.push_back(corner.second);
+                }
+                o_mesh.m_triangle_materials.push_back(current_material);
+            }
+        }
+    }
+    return true;
+}
+
+// Values per line of the arrays in generated headers
+static const int HEADER_FLOATS_PER_LINE = 6;
+static const int HEADER_INTS_PER_LINE = 12;
+
+static std::string header_identifier(const char* i_path) {
+    /* "include/meshes/submarine.hpp" becomes SUBMARINE */
+    std::string name = i_path;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) name = name.substr(slash + 1);
+    name = name.substr(0, name.find('.'));
+    for (char& c : name) {
+        c = isalnum((unsigned char)c) ? toupper((unsigned char)c) : '_';
+    }
+    if (name.empty() || isdigit((unsigned char)name[0])) name = "MESH_" + name;
+    return name;
+}
+
+static std::string float_literal(float i_value) {
+    /* 9 significant digits round-trip a float exactly */
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", i_value);
+    std::string literal = text;
+    if (literal.find_first_of(".e") == std::string::npos) literal += ".0";
+    return literal + "f";
+}
+
+template<typename T, typename Format>
+static void write_array(FILE* i_file, const char* i_type, const std::string& i_name,
+    const std::vector<T>& i_values, const char* i_size, int i_per_line, Format i_format) {
+    fprintf(i_file, "inline constexpr %s %s[%s] = {", i_type, i_name.c_str(), i_size);
+    for (size_t i = 0; i < i_values.size(); i++) {
+        fprintf(i_file, "%s%s,", i % i_per_line == 0 ? "\n    " : " ", i_format(i_values[i]).c_str());
+    }
+    fprintf(i_file, "\n};\n\n");
+}
+
+static bool write_header(const char* i_path, const char* i_source, const MeshFileHeader& i_header,
+    const std::vector<glm::vec3>& i_positions, const std::vector<int8_t>& i_normals,
+    const std::vector<uint16_t>& i_indices, const std::vector<uint16_t>& i_normal_indices,
+    const std::vector<float>& i_face_planes, const std::vector<MeshMaterialRange>& i_ranges) {
+    FILE* out = fopen(i_path, "w");
+    if (out == nullptr) {
+        fprintf(stderr, "objconvert: can't write %s\n", i_path);
+        return false;
+    }
+
+    /* Positions and normals go through the same quantization as the binary
+       format, so both forms of a mesh render identically */
+    std::vector<float> positions;
+    for (const glm::vec3& p : i_positions) {
+        positions.insert(positions.end(), { p.x, p.y, p.z });
+    }
+    std::vector<float> normals;
+    for (uint32_t i = 0; i < i_header.m_normal_count; i++) {
+        glm::vec3 n = decode_octahedral(&i_normals[i * 2]);
+        normals.insert(normals.end(), { n.x, n.y, n.z });
+    }
+
+    std::string name = header_identifier(i_path);
+    auto as_float = [](float v) { return float_literal(v); };
+    auto as_int = [](uint16_t v) { return std::to_string(v); };
+    const char* source = strrchr(i_source, '/') ? strrchr(i_source, '/') + 1 : i_source;
+
+    fprintf(out, "// Generated by tools/objconvert from %s, do not edit\n", source);
+    fprintf(out, "#pragma once\n\n#include \"EmbeddedMesh.hpp\"\n\n");
+    fprintf(out, "inline constexpr int %s_VERTEX_COUNT = %u;\n", name.c_str(), i_header.m_vertex_count);
+    fprintf(out, "inline constexpr int %s_NORMAL_COUNT = %u;\n", name.c_str(), i_header.m_normal_count);
+    fprintf(out, "inline constexpr int %s_TRIANGLE_COUNT = %u;\n", name.c_str(), i_header.m_triangle_count);
+    fprintf(out, "inline constexpr int %s_RANGE_COUNT = %u;\n\n", name.c_str(), i_header.m_range_count);
+
+    write_array(out, "float", name + "_POSITIONS", positions, (name + "_VERTEX_COUNT * 3").c_str(), HEADER_FLOATS_PER_LINE, as_float);
+    write_array(out, "float", name + "_NORMALS", normals, (name + "_NORMAL_COUNT * 3").c_str(), HEADER_FLOATS_PER_LINE, as_float);
+    write_array(out, "int", name + "_INDICES", i_indices, (name + "_TRIANGLE_COUNT * 3").c_str(), HEADER_INTS_PER_LINE, as_int);
+    write_array(out, "int", name + "_NORMAL_INDICES", i_normal_indices, (name + "_TRIANGLE_COUNT * 3").c_str(), HEADER_INTS_PER_LINE, as_int);
+
+    fprintf(out, "inline constexpr glm::vec4 %s_FACE_PLANES[%s_TRIANGLE_COUNT] = {\n", name.c_str(), name.c_str());
+    for (size_t i = 0; i + 3 < i_face_planes.size(); i += 4) {
+        fprintf(out, "    {%s, %s, %s, %s},\n", float_literal(i_face_planes[i]).c_str(),
+            float_literal(i_face_planes[i + 1]).c_str(), float_literal(i_face_planes[i + 2]).c_str(),
+            float_literal(i_face_planes[i + 3]).c_str());
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "inline constexpr MeshMaterialRange %s_MATERIAL_RANGES[%s_RANGE_COUNT] = {\n", name.c_str(), name.c_str());
+    for (const MeshMaterialRange& range : i_ranges) {
+        fprintf(out, "    {{%s, %s, %s}, {%s, %s, %s}, {%s, %s, %s}, %s, %u, %u, %u},\n",
+            float_literal(range.m_ambient[0]).c_str(), float_literal(range.m_ambient[1]).c_str(),
+            float_literal(range.m_ambient[2]).c_str(), float_literal(range.m_diffuse[0]).c_str(),
+            float_literal(range.m_diffuse[1]).c_str(), float_literal(range.m_diffuse[2]).c_str(),
+            float_literal(range.m_specular[0]).c_str(), float_literal(range.m_specular[1]).c_str(),
+            float_literal(range.m_specular[2]).c_str(), float_literal(range.m_shininess).c_str(),
+            range.m_dither_kernel, range.m_first_triangle, range.m_triangle_count);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "inline constexpr EmbeddedMesh %s_MESH{\n", name.c_str());
+    fprintf(out, "    %s_POSITIONS, %s_NORMALS, %s_INDICES, %s_NORMAL_INDICES,\n",
+        name.c_str(), name.c_str(), name.c_str(), name.c_str());
+    fprintf(out, "    %s_FACE_PLANES, %s_MATERIAL_RANGES,\n", name.c_str(), name.c_str());
+    fprintf(out, "    %s_VERTEX_COUNT, %s_NORMAL_COUNT, %s_TRIANGLE_COUNT, %s_RANGE_COUNT,\n",
+        name.c_str(), name.c_str(), name.c_str(), name.c_str());
+    fprintf(out, "    {%s, %s, %s}, %s\n};\n", float_literal(i_header.m_sphere_center[0]).c_str(),
+        float_literal(i_header.m_sphere_center[1]).c_str(), float_literal(i_header.m_sphere_center[2]).c_str(),
+        float_literal(i_header.m_sphere_radius).c_str());
+    fclose(out);
+    return true;
+}
+
+static void write_stream(FILE* i_file, const void* i_data, uint32_t i_size) {
+    static const uint8_t zeros[4] = { 0, 0, 0, 0 };
+    fwrite(i_data, 1, i_size, i_file);
+    fwrite(zeros, 1, mesh_stream_padding(i_size), i_file);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        fprintf(stderr, "usage: objconvert <input.obj> <output.mesh|output.hpp>\n");
+        return 1;
+    }
+
+    ObjMesh mesh;
+    if (!parse_obj(argv[1], mesh)) return 1;
+    if (mesh.m_positions.empty() || mesh.m_indices.empty()) {
+        fprintf(stderr, "objconvert: %s has no triangles\n", argv[1]);
+        return 1;
+    }
+
+    MeshFileHeader header{};
+    header.m_magic = MESH_FORMAT_MAGIC;
+    header.m_version = MESH_FORMAT_VERSION;
+
+    glm::vec3 min_corner = mesh.m_positions[0];
+    glm::vec3 max_corner = mesh.m_positions[0];
+    for (glm::vec3& p : mesh.m_positions) {
+        min_corner = glm::min(min_corner, p);
+        max_corner = glm::max(max_corner, p);
+    }
+    for (int k = 0; k < 3; k++) {
+        header.m_bounds_min[k] = min_corner[k];
+        header.m_bounds_max[k] = max_corner[k];
+    }
+
+    /* Quantize, then weld positions that land on the same grid point */
+    std::map<std::tuple<int16_t, int16_t, int16_t>, int> position_lookup;
+    std::vector<int16_t> positions;
+    std::vector<int> position_remap(mesh.m_positions.size());
+    for (size_t i = 0; i < mesh.m_positions.size(); i++) {
+        int16_t q[3];
+        for (int k = 0; k < 3; k++) {
+            q[k] = quantize_position(mesh.m_positions[i][k], min_corner[k], max_corner[k]);
+        }
+        auto key = std::make_tuple(q[0], q[1], q[2]);
+        auto found = position_lookup.find(key);
+        if (found == position_lookup.end()) {
+            found = position_lookup.emplace(key, positions.size() / 3).first;
+            positions.insert(positions.end(), q, q + 3);
+        }
+        position_remap[i] = found->second;
+    }
+
+    std::map<std::pair<int8_t, int8_t>, int> normal_lookup;
+    std::vector<int8_t> normals;
+    std::vector<int> normal_remap(mesh.m_normals.size());
+    for (size_t i = 0; i < mesh.m_normals.size(); i++) {
+        int8_t e[2];
+        encode_octahedral(mesh.m_normals[i], e);
+        auto key = std::make_pair(e[0], e[1]);
+        auto found = normal_lookup.find(key);
+        if (found == normal_lookup.end()) {
+            found = normal_lookup.emplace(key, normals.size() / 2).first;
+            normals.insert(normals.end(), e, e + 2);
+        }
+        normal_remap[i] = found->second;
+    }
+
+    header.m_vertex_count = positions.size() / 3;
+    header.m_normal_count = normals.size() / 2;
+    header.m_triangle_count = mesh.m_indices.size() / 3;
+    if (header.m_vertex_count > UINT16_MAX || header.m_normal_count > UINT16_MAX) {
+        fprintf(stderr, "objconvert: %s has too many vertices for 16-bit indices\n", argv[1]);
+        return 1;
+    }
+
+    /* Group triangles by material so each one is a single draw range */
+    std::vector<int> triangle_order(header.m_triangle_count);
+    for (uint32_t t = 0; t < header.m_triangle_count; t++) triangle_order[t] = t;
+    std::stable_sort(triangle_order.begin(), triangle_order.end(), [&mesh](int a, int b) {
+        return mesh.m_triangle_materials[a] < mesh.m_triangle_materials[b];
+    });
+
+    std::vector<uint16_t> indices;
+    std::vector<uint16_t> normal_indices;
+    std::vector<MeshMaterialRange> ranges;
+    for (uint32_t t = 0; t < header.m_triangle_count; t++) {
+        int source = triangle_order[t];
+        const ObjMaterial& material = mesh.m_materials[mesh.m_triangle_materials[source]];
+        if (t == 0 || mesh.m_triangle_materials[source] != mesh.m_triangle_materials[triangle_order[t - 1]]) {
+            MeshMaterialRange range{};
+            for (int k = 0; k < 3; k++) {
+                range.m_ambient[k] = material.m_ambient[k];
+                range.m_diffuse[k] = material.m_diffuse[k];
+                range.m_specular[k] = material.m_specular[k];
+            }
+            range.m_shininess = material.m_shininess;
+            range.m_dither_kernel = (uint32_t)material.m_dither_kernel;
+            range.m_first_triangle = t;
+            ranges.push_back(range);
+        }
+        ranges.back().m_triangle_count++;
+        for (int k = 0; k < 3; k++) {
+            indices.push_back(position_remap[mesh.m_indices[source * 3 + k]]);
+            normal_indices.push_back(normal_remap[mesh.m_normal_indices[source * 3 + k]]);
+        }
+    }
+    header.m_range_count = ranges.size();
+
+    /* Triangles for cache locality within each range, then both streams in
+       order of first use so the draw loop walks them front to back */
+    float acmr_before = average_cache_miss_ratio(indices, VERTEX_CACHE_SIZE);
+    for (MeshMaterialRange& range : ranges) {
+        auto first = range.m_first_triangle * 3;
+        auto last = first + range.m_triangle_count * 3;
+        std::vector<uint16_t> range_indices(indices.begin() + first, indices.begin() + last);
+        std::vector<uint16_t> range_normal_indices(normal_indices.begin() + first, normal_indices.begin() + last);
+        optimize_triangle_order(range_indices, range_normal_indices, header.m_vertex_count, VERTEX_CACHE_SIZE);
+        std::copy(range_indices.begin(), range_indices.end(), indices.begin() + first);
+        std::copy(range_normal_indices.begin(), range_normal_indices.end(), normal_indices.begin() + first);
+    }
+    float acmr_after = average_cache_miss_ratio(indices, VERTEX_CACHE_SIZE);
+
+    std::vector<int> position_order = order_by_first_use(indices, header.m_vertex_count);
+    std::vector<int16_t> ordered_positions(positions.size());
+    for (uint32_t i = 0; i < header.m_vertex_count; i++) {
+        for (int k = 0; k < 3; k++) {
+            ordered_positions[position_order[i] * 3 + k] = positions[i * 3 + k];
+        }
+    }
+    positions.swap(ordered_positions);
+
+    std::vector<int> normal_order = order_by_first_use(normal_indices, header.m_normal_count);
+    std::vector<int8_t> ordered_normals(normals.size());
+    for (uint32_t i = 0; i < header.m_normal_count; i++) {
+        ordered_normals[normal_order[i] * 2] = normals[i * 2];
+        ordered_normals[normal_order[i] * 2 + 1] = normals[i * 2 + 1];
+    }
+    normals.swap(ordered_normals);
+
+    /* Bounds and planes come from the dequantized positions the game will see */
+    std::vector<glm::vec3> decoded(header.m_vertex_count);
+    for (uint32_t i = 0; i < header.m_vertex_count; i++) {
+        for (int k = 0; k < 3; k++) {
+            decoded[i][k] = dequantize_position(positions[i * 3 + k], min_corner[k], max_corner[k]);
+        }
+    }
+    glm::vec3 center = (min_corner + max_corner) * 0.5f;
+    float radius_sqr = 0.0f;
+    for (glm::vec3& p : decoded) {
+        radius_sqr = fmaxf(radius_sqr, glm::dot(p - center, p - center));
+    }
+    for (int k = 0; k < 3; k++) {
+        header.m_sphere_center[k] = center[k];
+    }
+    header.m_sphere_radius = sqrtf(radius_sqr);
+
+    std::vector<float> face_planes;
+    face_planes.reserve(header.m_triangle_count * 4);
+    for (uint32_t t = 0; t < header.m_triangle_count; t++) {
+        glm::vec3 a = decoded[indices[t * 3]];
+        glm::vec3 n = glm::cross(decoded[indices[t * 3 + 1]] - a, decoded[indices[t * 3 + 2]] - a);
+        face_planes.insert(face_planes.end(), { n.x, n.y, n.z, -glm::dot(n, a) });
+    }
+
+    std::string output_path = argv[2];
+    bool as_header = output_path.size() > 4 && output_path.compare(output_path.size() - 4, 4, ".hpp") == 0;
+    if (as_header) {
+        if (!write_header(argv[2], argv[1], header, decoded, normals, indices, normal_indices, face_planes, ranges)) {
+            return 1;
+        }
+    } else {
+        FILE* out = fopen(argv[2], "wb");
+        if (out == nullptr) {
+            fprintf(stderr, "objconvert: can't write %s\n", argv[2]);
+            return 1;
+        }
+        fwrite(&header, sizeof(header), 1, out);
+        write_stream(out, positions.data(), positions.size() * sizeof(int16_t));
+        write_stream(out, normals.data(), normals.size() * sizeof(int8_t));
+        write_stream(out, indices.data(), indices.size() * sizeof(uint16_t));
+        write_stream(out, normal_indices.data(), normal_indices.size() * sizeof(uint16_t));
+        write_stream(out, face_planes.data(), face_planes.size() * sizeof(float));
+        write_stream(out, ranges.data(), ranges.size() * sizeof(MeshMaterialRange));
+        fclose(out);
+    }
+
+    printf("%s: %u vertices (%zu welded), %u normals, %u triangles\n", argv[2],
+        header.m_vertex_count, mesh.m_positions.size() - header.m_vertex_count,
+        header.m_normal_count, header.m_triangle_count);
+    printf("%s: %u material ranges\n", argv[2], header.m_range_count);
+    printf("%s: ACMR %.3f -> %.3f (FIFO %d)\n", argv[2], acmr_before, acmr_after, VERTEX_CACHE_SIZE);
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Checks that AssetLoader::purge_unused frees a cached mesh with LODs once
+// nothing outside the cache uses it, though its LODs keep it alive to
+// borrow its normals, and keeps it while a SceneObject still draws it.
+// Also checks that two different files whose contents hash the same each
+// get their own mesh, while a copy of a file shares the original's. The
+// OBJ files for that are written to the working directory.
+//
+//   asset_loader_test <file.mesh>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "AssetLoader.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+#include "utils.hpp"
+
+static const int LOD_COUNT = 2;
+
+static const char* TRIANGLE_PATH = "asset_loader_triangle.obj";
+static const char* TRIANGLE_COPY_PATH = "asset_loader_triangle_copy.obj";
+static const char* QUAD_PATH = "asset_loader_quad.obj";
+
+static std::string comment_line(uint32_t i_value) {
+    char line[16];
+    snprintf(line, sizeof(line), "%08x\n", i_value);
+    return line;
+}
+
+static bool write_file(const char* i_path, const std::string& i_contents) {
+    FILE* file = fopen(i_path, "wb");
+    if (file == nullptr) return false;
+    fwrite(i_contents.data(), 1, i_contents.size(), file);
+    fclose(file);
+    return true;
+}
+
+/* Different meshes whose FNV-1a hashes collide, found by varying a comment
+   at the end of each. About 2^16 tries per file are expected. */
+static bool write_colliding_files() {
+    std::string triangle = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n# ";
+    std::string quad = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 2 4 3\n# ";
+    uint32_t triangle_hash = fnv1a_hash(triangle.data(), triangle.size());
+    uint32_t quad_hash = fnv1a_hash(quad.data(), quad.size());
+
+    const uint32_t tries = 1 << 17;
+    std::unordered_map<uint32_t, uint32_t> triangle_by_hash;
+    for (uint32_t i = 0; i < tries; i++) {
+        std::string line = comment_line(i);
+        triangle_by_hash[fnv1a_hash(line.data(), line.size(), triangle_hash)] = i;
+    }
+    for (uint32_t i = 0; i < tries * 16; i++) {
+        std::string line = comment_line(i);
+        auto found = triangle_by_hash.find(fnv1a_hash(line.data(), line.size(), quad_hash));
+        if (found == triangle_by_hash.end()) continue;
+        std::string triangle_file = triangle + comment_line(found->second);
+        return write_file(TRIANGLE_PATH, triangle_file)
+            && write_file(TRIANGLE_COPY_PATH, triangle_file)
+            && write_file(QUAD_PATH, quad + line);
+    }
+    return false;
+}
+
+static void check_hash_collision(PlaydateAPI* pd) {
+    CHECK(write_colliding_files(), "couldn't write files with colliding hashes");
+    if (s_failures > 0) return;
+
+    AssetLoader loader;
+    std::shared_ptr<MeshHandle> triangle = loader.load_mesh(TRIANGLE_PATH);
+    std::shared_ptr<MeshHandle> quad = loader.load_mesh(QUAD_PATH);
+    std::shared_ptr<MeshHandle> copy = loader.load_mesh(TRIANGLE_COPY_PATH);
+    while (loader.update(pd)) {}
+    CHECK(triangle->m_ready && quad->m_ready && copy->m_ready, "the OBJ files didn't load");
+    if (s_failures > 0) return;
+
+    CHECK(triangle->m_content_fingerprint.m_hash == quad->m_content_fingerprint.m_hash,
+        "the files' hashes don't collide");
+    CHECK(quad->m_vertex_data != triangle->m_vertex_data, "a different file with the same hash shared its mesh");
+    CHECK(quad->m_vertex_data->triangle_count() == 2, "the quad has %d triangles",
+        quad->m_vertex_data->triangle_count());
+    CHECK(copy->m_vertex_data == triangle->m_vertex_data, "a copy of a file didn't share its mesh");
+
+    remove(TRIANGLE_PATH);
+    remove(TRIANGLE_COPY_PATH);
+    remove(QUAD_PATH);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.mesh>\n", argv[0]);
+        return 2;
+    }
+    PlaydateAPI* pd = get_host_playdate_api();
+    AssetLoader loader;
+
+    std::shared_ptr<MeshHandle> handle = loader.load_mesh(argv[1], LOD_COUNT);
+    while (loader.update(pd)) {}
+    CHECK(handle->m_ready, "%s didn't load", argv[1]);
+    CHECK((int)handle->m_lods.size() == LOD_COUNT, "%zu LODs", handle->m_lods.size());
+    if (s_failures > 0) return 1;
+    std::weak_ptr<IndexedVertexData> mesh = handle->m_vertex_data;
+    std::weak_ptr<VertexData> lod = handle->m_lods[0];
+
+    /* In use by an object, so kept */
+    SceneObject object;
+    object.set_mesh_handle(handle);
+    CHECK(object.is_loaded(), "the object didn't pick up the mesh");
+    handle = nullptr;
+    CHECK(loader.purge_unused() == 0, "purged a mesh an object still uses");
+    CHECK(!mesh.expired(), "the mesh was freed under the object");
+
+    /* Nothing outside the cache left */
+    object = SceneObject();
+    CHECK(loader.purge_unused() == 1, "cached mesh with LODs not purged");
+    CHECK(mesh.expired(), "mesh still alive after purging, %ld references", mesh.use_count());
+    CHECK(lod.expired(), "LOD still alive after purging");
+
+    check_hash_collision(pd);
+
+    if (report_failures() != 0) return 1;
+    printf("%s: mesh with %d LODs purged once unused, colliding files kept apart\n", argv[1], LOD_COUNT);
+    return 0;
+}
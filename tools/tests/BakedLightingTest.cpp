@@ -0,0 +1,88 @@
+// Checks that baked lighting belongs to the object it was baked for, draws
+// like the live lighting it replaces, and is dropped once the object moves
+// or its lights change.
+//
+//   baked_lighting_test
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "SceneObject.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+#include "meshes/cube.hpp"
+
+int main() {
+    PlaydateAPI* pd = get_host_playdate_api();
+    Camera camera;
+    Lighting lighting;
+    DirectionalLight sun;
+    sun.m_direction = glm::normalize(glm::vec3(0.3f, -1.0f, -0.5f));
+    lighting.set_directional_light(sun);
+    lighting.set_ambient(0.1f);
+
+    std::shared_ptr<IndexedVertexData> mesh = std::make_shared<IndexedVertexData>(CUBE_MESH);
+    SceneObject baked_object(mesh);
+    SceneObject other_object(mesh);
+    baked_object.rotate(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+    other_object.rotate(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+
+    /* Objects sharing a mesh don't share its bake */
+    baked_object.bake_lighting(lighting);
+    CHECK(baked_object.has_baked_lighting(), "bake_lighting baked nothing");
+    CHECK(!other_object.has_baked_lighting(), "bake leaked to another object sharing the mesh");
+
+    /* With no point lights the bake draws what live lighting does, up to
+       live lighting's normals being rounded to palette entries */
+    for (ShadingMode mode : {ShadingMode::Smooth, ShadingMode::Flat}) {
+        DrawStyle style;
+        style.m_shading_mode = mode;
+        baked_object.set_draw_style(style);
+        other_object.set_draw_style(style);
+        TestTarget baked_target;
+        TestTarget live_target;
+        baked_object.draw(camera, pd, baked_target.m_target, lighting);
+        other_object.draw(camera, pd, live_target.m_target, lighting);
+        CHECK(baked_object.has_baked_lighting(), "drawing with the baked lights dropped the bake");
+        int drawn = 0;
+        int differing = 0;
+        for (size_t i = 0; i < live_target.m_data.size(); i++) {
+            drawn += __builtin_popcount((uint8_t)~live_target.m_data[i]);
+            differing += __builtin_popcount(baked_target.m_data[i] ^ live_target.m_data[i]);
+        }
+        CHECK(drawn > 0, "mode %d: nothing drawn", (int)mode);
+        CHECK(differing * 20 < drawn, "mode %d: %d of %d pixels differ from live lighting",
+            (int)mode, differing, drawn);
+    }
+
+    /* Changing the ambient or directional light drops the bake */
+    lighting.set_ambient(0.3f);
+    TestTarget target;
+    baked_object.draw(camera, pd, target.m_target, lighting);
+    CHECK(!baked_object.has_baked_lighting(), "bake survived an ambient change");
+
+    baked_object.bake_lighting(lighting);
+    sun.m_intensity = 0.5f;
+    lighting.set_directional_light(sun);
+    baked_object.draw(camera, pd, target.m_target, lighting);
+    CHECK(!baked_object.has_baked_lighting(), "bake survived a directional light change");
+
+    /* So does moving the object or drawing it under other lights */
+    baked_object.bake_lighting(lighting);
+    baked_object.set_position(glm::vec3(0.5f, 0.0f, 0.0f));
+    baked_object.draw(camera, pd, target.m_target, lighting);
+    CHECK(!baked_object.has_baked_lighting(), "bake survived a move");
+
+    baked_object.bake_lighting(lighting);
+    Lighting other_lighting;
+    baked_object.draw(camera, pd, target.m_target, other_lighting);
+    CHECK(!baked_object.has_baked_lighting(), "bake survived drawing with other lights");
+
+    baked_object.bake_lighting(lighting);
+    baked_object.clear_baked_lighting();
+    CHECK(!baked_object.has_baked_lighting(), "clear_baked_lighting left a bake");
+
+    if (report_failures() != 0) return 1;
+    printf("baked lighting checks passed\n");
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Checks that BinaryMeshLoader hands a mesh to IndexedVertexData without
+// intermediate copies: one allocation per stream, sized for the final
+// buffer, nothing allocated while the streams are read, and no stream
+// copied when the mesh is built.
+//
+//   binary_mesh_loader_test <file.mesh>
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "BinaryMeshLoader.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+
+/* Counting allocator, every block carries its size in front of it */
+
+static constexpr size_t ALLOCATION_HEADER = 16;
+static constexpr int MAX_RECORDED_ALLOCATIONS = 4096;
+
+static bool s_tracking = false;
+static size_t s_live_bytes = 0;
+static size_t s_peak_bytes = 0;
+static int s_allocation_count = 0;
+static size_t s_allocation_sizes[MAX_RECORDED_ALLOCATIONS];
+
+static void* counted_alloc(size_t i_size) {
+    char* block = (char*)malloc(i_size + ALLOCATION_HEADER);
+    if (block == nullptr) throw std::bad_alloc();
+    *(size_t*)block = i_size;
+    if (s_tracking) {
+        s_live_bytes += i_size;
+        if (s_live_bytes > s_peak_bytes) s_peak_bytes = s_live_bytes;
+        if (s_allocation_count < MAX_RECORDED_ALLOCATIONS) {
+            s_allocation_sizes[s_allocation_count] = i_size;
+        }
+        s_allocation_count++;
+    }
+    return block + ALLOCATION_HEADER;
+}
+
+static void counted_free(void* i_ptr) {
+    if (i_ptr == nullptr) return;
+    char* block = (char*)i_ptr - ALLOCATION_HEADER;
+    if (s_tracking) s_live_bytes -= *(size_t*)block;
+    free(block);
+}
+
+void* operator new(size_t i_size) { return counted_alloc(i_size); }
+void* operator new[](size_t i_size) { return counted_alloc(i_size); }
+void operator delete(void* i_ptr) noexcept { counted_free(i_ptr); }
+void operator delete[](void* i_ptr) noexcept { counted_free(i_ptr); }
+void operator delete(void* i_ptr, size_t) noexcept { counted_free(i_ptr); }
+void operator delete[](void* i_ptr, size_t) noexcept { counted_free(i_ptr); }
+
+static void start_tracking() {
+    s_live_bytes = 0;
+    s_peak_bytes = 0;
+    s_allocation_count = 0;
+    s_tracking = true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.mesh>\n", argv[0]);
+        return 2;
+    }
+    PlaydateAPI* pd = get_host_playdate_api();
+
+    MeshFileHeader header;
+    FILE* file = fopen(argv[1], "rb");
+    CHECK(file != nullptr && fread(&header, sizeof(header), 1, file) == 1, "can't read %s", argv[1]);
+    if (file != nullptr) fclose(file);
+    if (s_failures > 0) return 1;
+
+    /* Bytes of each buffer the mesh ends up owning */
+    const size_t stream_sizes[] = {
+        header.m_vertex_count * 3 * sizeof(float),
+        header.m_normal_count * 3 * sizeof(float),
+        header.m_triangle_count * 3 * sizeof(int),
+        header.m_triangle_count * 3 * sizeof(int),
+        header.m_triangle_count * sizeof(glm::vec4),
+        header.m_range_count * sizeof(MeshMaterialRange)
+    };
+    size_t mesh_bytes = 0;
+    for (size_t size : stream_sizes) mesh_bytes += size;
+
+    BinaryMeshLoader loader;
+    std::string path = argv[1];
+
+    /* begin_load allocates every stream buffer, each exactly once */
+    start_tracking();
+    bool begun = loader.begin_load(path, pd);
+    s_tracking = false;
+    CHECK(begun, "begin_load failed");
+    int begin_allocations = s_allocation_count;
+    size_t begin_sizes[MAX_RECORDED_ALLOCATIONS];
+    for (int i = 0; i < begin_allocations && i < MAX_RECORDED_ALLOCATIONS; i++) {
+        begin_sizes[i] = s_allocation_sizes[i];
+    }
+    /* Equal sized streams, such as the two index streams, are counted together */
+    for (size_t stream = 0; stream < 6; stream++) {
+        if (stream_sizes[stream] == 0) continue;
+        int expected = 0;
+        for (size_t other = 0; other < 6; other++) {
+            if (stream_sizes[other] == stream_sizes[stream]) expected++;
+        }
+        int found = 0;
+        for (int i = 0; i < begin_allocations; i++) {
+            if (begin_sizes[i] == stream_sizes[stream]) found++;
+        }
+        CHECK(found == expected, "stream %zu: %d allocations of %zu bytes, expected %d",
+            stream, found, stream_sizes[stream], expected);
+    }
+
+    /* Streams are read into those buffers and widened in place */
+    s_tracking = true;
+    size_t begin_live = s_live_bytes;
+    int reads_before = get_host_read_count();
+    while (!loader.continue_load(pd)) {}
+    s_tracking = false;
+    CHECK(s_allocation_count == begin_allocations, "continue_load allocated %d times",
+        s_allocation_count - begin_allocations);
+    CHECK(get_host_read_count() - reads_before <= 6, "%d reads for 6 streams",
+        get_host_read_count() - reads_before);
+    CHECK(s_live_bytes == begin_live, "continue_load left %zu bytes live, begin_load %zu",
+        s_live_bytes, begin_live);
+
+    /* About one copy of the mesh at peak, the path string and such on top */
+    const size_t slack = 1024;
+    size_t streaming_peak = s_peak_bytes;
+    CHECK(streaming_peak <= mesh_bytes + slack, "peak %zu bytes while streaming, mesh is %zu",
+        streaming_peak, mesh_bytes);
+
+    /* finish_load moves the buffers in, so none of them is allocated again */
+    int finish_start = s_allocation_count;
+    s_tracking = true;
+    std::shared_ptr<IndexedVertexData> mesh = loader.finish_load(pd);
+    s_tracking = false;
+    CHECK(mesh != nullptr, "finish_load failed");
+    for (int i = finish_start; i < s_allocation_count && i < MAX_RECORDED_ALLOCATIONS; i++) {
+        for (size_t stream = 0; stream < 4; stream++) {
+            CHECK(s_allocation_sizes[i] != stream_sizes[stream] || stream_sizes[stream] == 0,
+                "finish_load allocated %zu bytes, the size of stream %zu", s_allocation_sizes[i], stream);
+        }
+    }
+    if (mesh != nullptr) {
+        CHECK(mesh->get_vertex_buffer().size() == header.m_vertex_count * 3, "vertex count");
+        CHECK(mesh->triangle_count() == (int)header.m_triangle_count, "triangle count");
+    }
+
+    printf("%s: %zu mesh bytes, %d allocations in begin_load, peak %zu bytes while streaming\n",
+        argv[1], mesh_bytes, begin_allocations, streaming_peak);
+    if (report_failures() != 0) return 1;
+    return 0;
+}
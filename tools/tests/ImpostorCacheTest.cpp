@@ -0,0 +1,93 @@
+// Checks that cached impostors are re-rendered when what they show goes
+// out of date: the object at an address is replaced, a light moves, or the
+// object moves into denser fog. Each draw through a warm cache must match
+// a draw through an empty one. A light moving out of the object's range
+// must not cost a re-render.
+//
+//   impostor_cache_test
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "ImpostorCache.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+#include "meshes/cube.hpp"
+#include "meshes/icosahedron.hpp"
+
+static PlaydateAPI* s_pd;
+static Camera s_camera;
+
+static std::vector<uint8_t> draw_through(ImpostorCache& i_cache, SceneObject& i_object, Lighting& i_lighting) {
+    TestTarget target;
+    i_cache.begin_frame();
+    i_cache.draw(i_object, s_camera, s_pd, target.m_target, i_lighting);
+    return target.m_data;
+}
+
+/* Draws i_object through the warm cache and through an empty one */
+static void check_fresh(ImpostorCache& i_cache, SceneObject& i_object, Lighting& i_lighting, const char* i_what) {
+    ImpostorCache empty_cache;
+    std::vector<uint8_t> cached = draw_through(i_cache, i_object, i_lighting);
+    std::vector<uint8_t> fresh = draw_through(empty_cache, i_object, i_lighting);
+    CHECK(cached == fresh, "stale impostor drawn after %s", i_what);
+}
+
+int main() {
+    s_pd = get_host_playdate_api();
+    Lighting lighting;
+    lighting.add_point_light(PointLight{});
+    lighting.set_point_light_position(0, glm::vec3(0.0f, 3.0f, -16.0f));
+    /* Far beyond its range of about 60 units */
+    const int far_light = 1;
+    lighting.add_point_light(PointLight{});
+    lighting.set_point_light_position(far_light, glm::vec3(200.0f, 0.0f, -18.0f));
+
+    /* Small enough on screen to go through an impostor */
+    const glm::vec3 position{0.0f, 0.0f, -18.0f};
+    SceneObject object(std::make_shared<IndexedVertexData>(CUBE_MESH));
+    object.set_position(position);
+    object.rotate(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+    ImpostorCache cache;
+    std::vector<uint8_t> first = draw_through(cache, object, lighting);
+    CHECK(first == draw_through(cache, object, lighting), "cached impostor differs from the one just rendered");
+
+    /* Ids survive a move, so impostors of a moved object stay valid */
+    int id = object.get_id();
+    SceneObject moved(std::move(object));
+    CHECK(moved.get_id() == id, "id %d became %d when moved", id, moved.get_id());
+    object = std::move(moved);
+
+    /* Another object assigned to the same variable is not the same object */
+    object = SceneObject(std::make_shared<IndexedVertexData>(ICOSAHEDRON_MESH));
+    object.set_position(position);
+    object.rotate(30.0f, glm::vec3(1.0f, 1.0f, 0.0f));
+    CHECK(object.get_id() != id, "a new object took over id %d", id);
+    check_fresh(cache, object, lighting, "replacing the object");
+
+    /* Lights baked into the sprite */
+    lighting.set_point_light_position(0, glm::vec3(3.0f, -2.0f, -15.0f));
+    check_fresh(cache, object, lighting, "moving a point light");
+    lighting.set_ambient(0.4f);
+    check_fresh(cache, object, lighting, "changing the ambient light");
+
+    /* Further along the same line of sight, in the same distance bucket,
+       but through denser fog */
+    object.set_position(glm::vec3(0.0f, 0.0f, -21.5f));
+    check_fresh(cache, object, lighting, "moving into denser fog");
+
+    /* A light that doesn't reach the object keeps its impostor. Drawing
+       flat instead, which the key leaves out, shows whether it was kept. */
+    std::vector<uint8_t> cached = draw_through(cache, object, lighting);
+    DrawStyle flat_style;
+    flat_style.m_shading_mode = ShadingMode::Flat;
+    object.set_draw_style(flat_style);
+    lighting.set_point_light_position(far_light, glm::vec3(-200.0f, 0.0f, -18.0f));
+    ImpostorCache empty_cache;
+    CHECK(draw_through(empty_cache, object, lighting) != cached, "flat and smooth draws match");
+    CHECK(draw_through(cache, object, lighting) == cached, "moving a far away light re-rendered the impostor");
+
+    if (report_failures() != 0) return 1;
+    printf("impostor cache checks passed\n");
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Checks that an InstancedSceneObject draws exactly what the same copies
+// drawn as separate SceneObjects do: same pixels, same depth. The copies
+// overlap, reach off screen and include one behind the camera.
+//
+//   instanced_draw_test
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <glm/gtc/quaternion.hpp>
+#include "SceneObject.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+#include "meshes/submarine.hpp"
+
+static std::vector<Transform> make_transforms() {
+    std::vector<Transform> transforms;
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 5; x++) {
+            Transform tf;
+            tf.m_position = glm::vec3(x * 3.0f - 7.0f, y * 2.5f - 2.5f, -12.0f - x - y * 2.0f);
+            tf.m_rotation = glm::angleAxis(glm::radians(25.0f * (x + y * 5)),
+                glm::normalize(glm::vec3(1.0f, 0.5f + y, 0.25f * x)));
+            tf.m_scale = glm::vec3(0.4f + 0.1f * y);
+            transforms.push_back(tf);
+        }
+    }
+    Transform behind;
+    behind.m_position = glm::vec3(0.0f, 0.0f, 20.0f);
+    transforms.push_back(behind);
+    return transforms;
+}
+
+int main() {
+    PlaydateAPI* pd = get_host_playdate_api();
+    Camera camera;
+    Lighting lighting;
+    lighting.set_ambient(0.2f);
+    PointLight lamp;
+    lamp.m_light_pos = glm::vec4(-2.0f, 3.0f, -10.0f, 1.0f);
+    lighting.add_point_light(lamp);
+
+    std::shared_ptr<IndexedVertexData> mesh = std::make_shared<IndexedVertexData>(SUBMARINE_MESH);
+    std::vector<Transform> transforms = make_transforms();
+
+    for (ShadingMode mode : {ShadingMode::Smooth, ShadingMode::Flat}) {
+        DrawStyle style;
+        style.m_shading_mode = mode;
+
+        TestTarget separate_target;
+        for (const Transform& tf : transforms) {
+            SceneObject object(mesh);
+            object.set_transform(tf);
+            object.set_draw_style(style);
+            object.draw(camera, pd, separate_target.m_target, lighting);
+        }
+
+        TestTarget instanced_target;
+        InstancedSceneObject instanced(mesh);
+        instanced.set_draw_style(style);
+        for (const Transform& tf : transforms) {
+            instanced.add_instance(tf);
+        }
+        instanced.draw(camera, pd, instanced_target.m_target, lighting);
+
+        int drawn = 0;
+        int differing = 0;
+        for (size_t i = 0; i < separate_target.m_data.size(); i++) {
+            drawn += __builtin_popcount((uint8_t)~separate_target.m_data[i]);
+            differing += __builtin_popcount(separate_target.m_data[i] ^ instanced_target.m_data[i]);
+        }
+        CHECK(drawn > 0, "mode %d: nothing drawn", (int)mode);
+        CHECK(differing == 0, "mode %d: %d pixels differ", (int)mode, differing);
+        CHECK(separate_target.m_depth == instanced_target.m_depth, "mode %d: depth differs", (int)mode);
+    }
+
+    if (report_failures() != 0) return 1;
+    printf("instanced draws match %zu separate objects\n", transforms.size());
+    return 0;
+}
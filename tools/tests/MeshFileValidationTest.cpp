@@ -0,0 +1,149 @@
+// Checks that BinaryMeshLoader rejects mesh files whose size, indices or
+// material ranges don't fit the counts in their header, by loading
+// corrupted copies of a good file. The copies are written to the working
+// directory.
+//
+//   mesh_file_validation_test <file.mesh>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+#include "BinaryMeshLoader.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+
+static const char* CORRUPT_PATH = "mesh_file_validation.mesh";
+
+static size_t padded(size_t i_size) {
+    return i_size + mesh_stream_padding(i_size);
+}
+
+/* Byte offsets of the streams, in file order */
+struct StreamOffsets {
+    size_t m_indices;
+    size_t m_normal_indices;
+    size_t m_ranges;
+};
+
+static StreamOffsets get_stream_offsets(const MeshFileHeader& i_header) {
+    StreamOffsets offsets;
+    size_t index_bytes = padded(i_header.m_triangle_count * 3 * sizeof(uint16_t));
+    offsets.m_indices = sizeof(MeshFileHeader)
+        + padded(i_header.m_vertex_count * 3 * sizeof(int16_t))
+        + padded(i_header.m_normal_count * 2);
+    offsets.m_normal_indices = offsets.m_indices + index_bytes;
+    offsets.m_ranges = offsets.m_normal_indices + index_bytes
+        + i_header.m_triangle_count * 4 * sizeof(float);
+    return offsets;
+}
+
+/* Loads i_bytes from disk, returns whether a mesh came out of it */
+static bool load(const std::vector<uint8_t>& i_bytes, PlaydateAPI* pd) {
+    FILE* file = fopen(CORRUPT_PATH, "wb");
+    if (file == nullptr) return false;
+    fwrite(i_bytes.data(), 1, i_bytes.size(), file);
+    fclose(file);
+
+    BinaryMeshLoader loader;
+    if (!loader.begin_load(CORRUPT_PATH, pd)) return false;
+    while (!loader.continue_load(pd)) {}
+    return loader.finish_load(pd) != nullptr;
+}
+
+template<typename T>
+static void poke(std::vector<uint8_t>& io_bytes, size_t i_offset, T i_value) {
+    memcpy(&io_bytes[i_offset], &i_value, sizeof(T));
+}
+
+template<typename T>
+static T peek(const std::vector<uint8_t>& i_bytes, size_t i_offset) {
+    T value;
+    memcpy(&value, &i_bytes[i_offset], sizeof(T));
+    return value;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <file.mesh>\n", argv[0]);
+        return 2;
+    }
+    PlaydateAPI* pd = get_host_playdate_api();
+
+    std::vector<uint8_t> good;
+    FILE* file = fopen(argv[1], "rb");
+    CHECK(file != nullptr, "can't read %s", argv[1]);
+    if (file == nullptr) return 1;
+    int c;
+    while ((c = fgetc(file)) != EOF) good.push_back((uint8_t)c);
+    fclose(file);
+
+    MeshFileHeader header;
+    memcpy(&header, good.data(), sizeof(header));
+    StreamOffsets offsets = get_stream_offsets(header);
+    CHECK(header.m_range_count > 0, "%s has no material ranges to corrupt", argv[1]);
+    CHECK(offsets.m_ranges + header.m_range_count * sizeof(MeshMaterialRange) == good.size(),
+        "stream offsets don't add up to the file size");
+    CHECK(mesh_file_size(header) == good.size(), "mesh_file_size gives %llu bytes for %zu",
+        (unsigned long long)mesh_file_size(header), good.size());
+    if (s_failures > 0) return 1;
+
+    int errors = get_host_error_count();
+    CHECK(load(good, pd), "the unmodified file didn't load");
+    CHECK(get_host_error_count() == errors, "the unmodified file reported errors");
+
+    size_t last_range = offsets.m_ranges + (header.m_range_count - 1) * sizeof(MeshMaterialRange);
+    struct Corruption {
+        const char* m_name;
+        std::function<void(std::vector<uint8_t>&)> m_apply;
+    };
+    const Corruption corruptions[] = {
+        { "a vertex index past the vertices", [&](std::vector<uint8_t>& bytes) {
+            poke<uint16_t>(bytes, offsets.m_indices, (uint16_t)header.m_vertex_count);
+        } },
+        { "a normal index past the normals", [&](std::vector<uint8_t>& bytes) {
+            size_t last = offsets.m_normal_indices + (header.m_triangle_count * 3 - 1) * sizeof(uint16_t);
+            poke<uint16_t>(bytes, last, (uint16_t)header.m_normal_count);
+        } },
+        { "a first range not starting at triangle 0", [&](std::vector<uint8_t>& bytes) {
+            poke<uint32_t>(bytes, offsets.m_ranges + offsetof(MeshMaterialRange, m_first_triangle), 1);
+        } },
+        { "ranges ending short of the last triangle", [&](std::vector<uint8_t>& bytes) {
+            size_t count = last_range + offsetof(MeshMaterialRange, m_triangle_count);
+            poke<uint32_t>(bytes, count, peek<uint32_t>(bytes, count) - 1);
+        } },
+        { "ranges running past the last triangle", [&](std::vector<uint8_t>& bytes) {
+            size_t count = last_range + offsetof(MeshMaterialRange, m_triangle_count);
+            poke<uint32_t>(bytes, count, peek<uint32_t>(bytes, count) + 1);
+        } },
+        { "its streams cut short", [&](std::vector<uint8_t>& bytes) {
+            bytes.resize(offsets.m_normal_indices);
+        } },
+        { "bytes past its last stream", [&](std::vector<uint8_t>& bytes) {
+            bytes.resize(bytes.size() + 4);
+        } },
+        { "more vertices than the file holds", [&](std::vector<uint8_t>& bytes) {
+            poke<uint32_t>(bytes, offsetof(MeshFileHeader, m_vertex_count), header.m_vertex_count + 2);
+        } },
+        { "a triangle count whose index count wraps 32 bits", [&](std::vector<uint8_t>& bytes) {
+            poke<uint32_t>(bytes, offsetof(MeshFileHeader, m_triangle_count), 0x55555556);
+        } },
+        { "a range count of 4 billion", [&](std::vector<uint8_t>& bytes) {
+            poke<uint32_t>(bytes, offsetof(MeshFileHeader, m_range_count), 0xFFFFFFFF);
+        } }
+    };
+    for (const Corruption& corruption : corruptions) {
+        std::vector<uint8_t> bytes = good;
+        corruption.m_apply(bytes);
+        errors = get_host_error_count();
+        CHECK(!load(bytes, pd), "loaded a mesh from a file with %s", corruption.m_name);
+        CHECK(get_host_error_count() > errors, "no error reported for a file with %s", corruption.m_name);
+    }
+    remove(CORRUPT_PATH);
+
+    if (report_failures() != 0) return 1;
+    printf("%s: %zu corruptions rejected\n", argv[1], sizeof(corruptions) / sizeof(corruptions[0]));
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Checks that simplified meshes keep each triangle's material when the
+// source mesh has a degenerate triangle, which the simplifier skips, lying
+// between two material ranges.
+//
+//   mesh_simplifier_test
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "MeshSimplifier.hpp"
+#include "SceneObject.hpp"
+#include "TestSupport.hpp"
+
+/* Gently curved grid, so collapses have a cost and an order */
+static const int GRID_SIZE = 6;
+
+static std::vector<float> make_grid_vertices() {
+    std::vector<float> vertices;
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            vertices.push_back((float)x);
+            vertices.push_back((float)y);
+            vertices.push_back(0.05f * (float)(x * x + y * y));
+        }
+    }
+    return vertices;
+}
+
+static void add_grid_quads(std::vector<int>& o_indices, int i_first_row, int i_last_row) {
+    for (int y = i_first_row; y < i_last_row; y++) {
+        for (int x = 0; x < GRID_SIZE - 1; x++) {
+            int v = y * GRID_SIZE + x;
+            o_indices.insert(o_indices.end(), {v, v + 1, v + GRID_SIZE + 1});
+            o_indices.insert(o_indices.end(), {v, v + GRID_SIZE + 1, v + GRID_SIZE});
+        }
+    }
+}
+
+int main() {
+    /* Lower half is material A, then a degenerate triangle at the end of
+       A's range, then the upper half as material B */
+    std::vector<float> vertices = make_grid_vertices();
+    std::vector<int> indices;
+    add_grid_quads(indices, 0, GRID_SIZE / 2);
+    indices.insert(indices.end(), {0, 1, 1});
+    int degenerate_triangle = indices.size() / 3 - 1;
+    int range_b_first_index = indices.size();
+    add_grid_quads(indices, GRID_SIZE / 2, GRID_SIZE - 1);
+    int triangle_count = indices.size() / 3;
+
+    /* A normal per corner, so every corner's index tells where it came from */
+    std::vector<float> normals;
+    std::vector<int> normal_indices;
+    for (int i = 0; i < (int)indices.size(); i++) {
+        normals.insert(normals.end(), {0.0f, 0.0f, 1.0f});
+        normal_indices.push_back(i);
+    }
+
+    std::shared_ptr<Material> material_a = std::make_shared<Material>();
+    std::shared_ptr<Material> material_b = std::make_shared<Material>();
+    std::shared_ptr<IndexedVertexData> mesh = std::make_shared<IndexedVertexData>(
+        vertices, indices, normals, normal_indices, 3);
+    mesh->set_material_ranges({
+        {0, range_b_first_index, material_a},
+        {range_b_first_index, (int)indices.size() - range_b_first_index, material_b}
+    });
+
+    /* Source triangles point at the triangle each corner came from */
+    for (int target : {triangle_count, triangle_count / 2, triangle_count / 4}) {
+        MeshSimplifier simplifier{vertices, indices, normal_indices};
+        simplifier.simplify(target);
+        std::vector<int> source_triangles = simplifier.get_source_triangles();
+        std::vector<int> simplified_normals = simplifier.get_normal_index_buffer();
+        CHECK(simplified_normals.size() == source_triangles.size() * 3, "target %d", target);
+        for (size_t t = 0; t < source_triangles.size() && t * 3 < simplified_normals.size(); t++) {
+            int source = source_triangles[t];
+            CHECK(source != degenerate_triangle, "target %d: triangle %zu from the degenerate one", target, t);
+            for (int k = 0; k < 3; k++) {
+                CHECK(simplified_normals[t * 3 + k] / 3 == source,
+                    "target %d: triangle %zu has a corner of %d, source says %d",
+                    target, t, simplified_normals[t * 3 + k] / 3, source);
+            }
+        }
+    }
+
+    /* With nothing collapsed, every triangle but the degenerate one keeps its material */
+    std::shared_ptr<IndexedVertexData> lod = mesh->create_lod(1.0f);
+    const std::vector<MaterialRange>& lod_ranges = lod->get_material_ranges();
+    CHECK(lod->triangle_count() == triangle_count - 1, "%d triangles", lod->triangle_count());
+    CHECK(lod_ranges.size() == 2, "%zu ranges", lod_ranges.size());
+    if (lod_ranges.size() == 2) {
+        CHECK(lod_ranges[0].m_material == material_a, "first range isn't material A");
+        CHECK(lod_ranges[0].m_first_index == 0 && lod_ranges[0].m_index_count == range_b_first_index - 3,
+            "material A covers %d indices from %d", lod_ranges[0].m_index_count, lod_ranges[0].m_first_index);
+        CHECK(lod_ranges[1].m_material == material_b, "second range isn't material B");
+        CHECK(lod_ranges[1].m_first_index == range_b_first_index - 3,
+            "material B starts at %d", lod_ranges[1].m_first_index);
+    }
+
+    /* Simplified ranges still tile the mesh */
+    for (float ratio : {0.5f, 0.25f}) {
+        std::shared_ptr<IndexedVertexData> simplified = mesh->create_lod(ratio);
+        int next_index = 0;
+        for (const MaterialRange& range : simplified->get_material_ranges()) {
+            CHECK(range.m_first_index == next_index, "ratio %g: range at %d, expected %d",
+                ratio, range.m_first_index, next_index);
+            next_index = range.m_first_index + range.m_index_count;
+        }
+        CHECK(next_index == simplified->triangle_count() * 3, "ratio %g: ranges end at %d of %d",
+            ratio, next_index, simplified->triangle_count() * 3);
+    }
+
+    printf("%d triangles, degenerate triangle %d dropped\n", triangle_count, degenerate_triangle);
+    if (report_failures() != 0) return 1;
+    return 0;
+}
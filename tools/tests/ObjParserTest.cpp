@@ -0,0 +1,56 @@
+// Checks the OBJ number parsers on digit runs too long for an int or a
+// float, and that WFObjLoader skips a face with a malformed corner whole
+// rather than drawing what's left of it. The OBJ file for that is written
+// to the working directory.
+//
+//   obj_parser_test
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include "ObjLexer.hpp"
+#include "WFObjLoader.hpp"
+#include "HostPlaydate.hpp"
+#include "TestSupport.hpp"
+
+static const char* OBJ_PATH = "obj_parser_test.obj";
+
+/* Two quads, the second with a corner that isn't a number */
+static const char* OBJ_CONTENTS =
+    "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+    "f 1 2 3 4\n"
+    "f 1 2 x 4\n";
+
+int main() {
+    int value = 0;
+    CHECK(parse_int("2147483647", value) && value == 2147483647, "INT_MAX not parsed");
+    CHECK(!parse_int("2147483648", value), "INT_MAX + 1 parsed");
+    CHECK(!parse_int(std::string(40, '9'), value), "40 digits parsed");
+    CHECK(parse_int("-2147483647", value) && value == -2147483647, "-INT_MAX not parsed");
+
+    float f = 0.0f;
+    CHECK(parse_float("1e2147483647", f) && std::isinf(f), "huge exponent not infinite");
+    CHECK(parse_float("1e-2147483647", f) && f == 0.0f, "tiny exponent not zero");
+    CHECK(parse_float(std::string(400, '9') + "e2147483647", f) && std::isinf(f),
+        "long mantissa with a huge exponent not infinite");
+    CHECK(!parse_float("1e99999999999", f), "exponent past INT_MAX parsed");
+    CHECK(parse_float("1.5e3", f) && f == 1500.0f, "1.5e3 parsed as %g", f);
+
+    FILE* file = fopen(OBJ_PATH, "wb");
+    CHECK(file != nullptr, "couldn't write %s", OBJ_PATH);
+    if (file != nullptr) {
+        fputs(OBJ_CONTENTS, file);
+        fclose(file);
+        WFObjLoader loader;
+        SceneObject object = loader.create_scene_object_from_file(OBJ_PATH, get_host_playdate_api());
+        auto mesh = std::dynamic_pointer_cast<IndexedVertexData>(object.get_vertex_data());
+        int triangles = mesh != nullptr ? mesh->triangle_count() : 0;
+        CHECK(triangles == 2, "%d triangles, the malformed face wasn't skipped whole", triangles);
+        remove(OBJ_PATH);
+    }
+
+    if (report_failures() != 0) return 1;
+    printf("obj parser checks passed\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Checks OcclusionBuffer against a square wall occluder: bounds wholly
+// behind the wall are occluded, bounds in front of it, reaching through
+// it or past its edge are not.
+//
+//   occlusion_buffer_test
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "OcclusionBuffer.hpp"
+#include "TestSupport.hpp"
+#include "meshes/cube.hpp"
+
+/* Camera at (0, 0, 5) looking down -z at a wall across z = -10 */
+static const float WALL_Z = -10.0f;
+static const float WALL_HALF_SIZE = 10.0f;
+
+static std::shared_ptr<IndexedVertexData> make_wall_mesh() {
+    std::vector<float> vertices = {
+        -WALL_HALF_SIZE, -WALL_HALF_SIZE, 0.0f,
+        WALL_HALF_SIZE, -WALL_HALF_SIZE, 0.0f,
+        WALL_HALF_SIZE, WALL_HALF_SIZE, 0.0f,
+        -WALL_HALF_SIZE, WALL_HALF_SIZE, 0.0f
+    };
+    std::vector<int> indices = {0, 1, 2, 0, 2, 3};
+    std::vector<float> normals = {0.0f, 0.0f, 1.0f};
+    std::vector<int> normal_indices = {0, 0, 0, 0, 0, 0};
+    return std::make_shared<IndexedVertexData>(vertices, indices, normals, normal_indices, 3);
+}
+
+int main() {
+    Camera camera;
+    std::shared_ptr<IndexedVertexData> wall_mesh = make_wall_mesh();
+    SceneObject wall(wall_mesh);
+    wall.set_occluder(wall_mesh);
+    wall.set_position(glm::vec3(0.0f, 0.0f, WALL_Z));
+
+    OcclusionBuffer buffer;
+    const glm::vec3 behind{0.0f, 0.0f, WALL_Z - 10.0f};
+    CHECK(!buffer.is_occluded(behind, 1.0f, camera), "an empty buffer occluded something");
+
+    buffer.add_occluder(wall, camera);
+    CHECK(buffer.is_occluded(behind, 1.0f, camera), "bounds behind the wall not occluded");
+    CHECK(buffer.is_occluded(glm::vec3(3.0f, -2.0f, WALL_Z - 0.5f), 0.25f, camera),
+        "bounds just behind the wall not occluded");
+    CHECK(!buffer.is_occluded(glm::vec3(0.0f, 0.0f, WALL_Z + 5.0f), 1.0f, camera),
+        "bounds in front of the wall occluded");
+    CHECK(!buffer.is_occluded(glm::vec3(0.0f, 0.0f, WALL_Z - 0.5f), 1.0f, camera),
+        "bounds centered behind the wall but reaching through it occluded");
+    CHECK(!buffer.is_occluded(glm::vec3(WALL_HALF_SIZE * 1.5f, 0.0f, WALL_Z - 2.0f), 1.0f, camera),
+        "bounds showing past the wall's edge occluded");
+
+    /* Objects are tested by their world bounds */
+    SceneObject box(std::make_shared<IndexedVertexData>(CUBE_MESH));
+    box.set_position(behind);
+    CHECK(buffer.is_occluded(box, camera), "object behind the wall not occluded");
+    box.set_position(glm::vec3(0.0f, 0.0f, WALL_Z + 5.0f));
+    CHECK(!buffer.is_occluded(box, camera), "object in front of the wall occluded");
+
+    buffer.clear();
+    CHECK(!buffer.is_occluded(behind, 1.0f, camera), "clear left the wall in");
+
+    if (report_failures() != 0) return 1;
+    printf("occlusion buffer checks passed\n");
+    return 0;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// What every host test shares: a failure counter with a CHECK macro that
+// logs and counts instead of stopping, and a screen sized render target.
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "RenderTarget.hpp"
+#include "ScreenGlobals.hpp"
+
+static int s_failures = 0;
+
+#define CHECK(condition, ...) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "FAILED %s:%d: %s: ", __FILE__, __LINE__, #condition); \
+            fprintf(stderr, __VA_ARGS__); \
+            fputc('\n', stderr); \
+            s_failures++; \
+        } \
+    } while (0)
+
+/* Exit status for main: prints the failure count if there were any */
+static inline int report_failures() {
+    if (s_failures > 0) {
+        fprintf(stderr, "%d checks failed\n", s_failures);
+        return 1;
+    }
+    return 0;
+}
+
+/* Screen sized bitmap and depth buffer, cleared to white and far */
+struct TestTarget {
+    std::vector<uint8_t> m_data;
+    std::vector<int> m_depth;
+    RenderTarget m_target;
+
+    TestTarget() {
+        int rowbytes = ((SCREEN_WIDTH + 31) / 32) * 4;
+        m_data.resize(rowbytes * SCREEN_HEIGHT);
+        m_depth.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+        m_target.m_data = m_data.data();
+        m_target.m_rowbytes = rowbytes;
+        m_target.m_depth_buffer = m_depth.data();
+        m_target.m_width = SCREEN_WIDTH;
+        m_target.m_height = SCREEN_HEIGHT;
+        clear();
+    }
+
+    void clear() {
+        std::fill(m_data.begin(), m_data.end(), 0xFF);
+        std::fill(m_depth.begin(), m_depth.end(), INT_MAX);
+    }
+};